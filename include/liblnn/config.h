@@ -48,6 +48,24 @@ namespace liblnn {
       hidden_width( 0 ),
       c1_channels( 0 ),
       c2_channels( 0 ),
+      clip_norm( 0.f ),
+      seed( 0 ),
+      dropout( 0.f ),
+      residual_blocks( 0 ),
+      leaky_slope( 0.f ),
+      separable( false ),
+      strided( false ),
+      global_pool( false ),
+      bias( false ),
+      nhwc( false ),
+      relu_mask( false ),
+      in_place( false ),
+      checkpoint( false ),
+      bf16( false ),
+      fused_block( false ),
+      batchnorm( false ),
+      megakernel( false ),
+      quantize( false ),
       debug_mode( false ) {}
     LIBLNN_SET_LARGE_VALUE( engine_name )
     LIBLNN_SET_LARGE_VALUE( engine_version )
@@ -57,6 +75,7 @@ namespace liblnn {
     LIBLNN_SET_SMALL_VALUE( device_index )
     LIBLNN_SET_SMALL_VALUE( validation )
     LIBLNN_SET_LARGE_VALUE( dump_file )
+    LIBLNN_SET_LARGE_VALUE( tuning_file )
     LIBLNN_SET_LARGE_VALUE( train_data )
     LIBLNN_SET_LARGE_VALUE( train_label )
     LIBLNN_SET_LARGE_VALUE( eval_data )
@@ -65,6 +84,24 @@ namespace liblnn {
     LIBLNN_SET_SMALL_VALUE( hidden_width )
     LIBLNN_SET_SMALL_VALUE( c1_channels )
     LIBLNN_SET_SMALL_VALUE( c2_channels )
+    LIBLNN_SET_SMALL_VALUE( clip_norm )
+    LIBLNN_SET_SMALL_VALUE( seed )
+    LIBLNN_SET_SMALL_VALUE( dropout )
+    LIBLNN_SET_SMALL_VALUE( residual_blocks )
+    LIBLNN_SET_SMALL_VALUE( leaky_slope )
+    LIBLNN_SET_SMALL_VALUE( separable )
+    LIBLNN_SET_SMALL_VALUE( strided )
+    LIBLNN_SET_SMALL_VALUE( global_pool )
+    LIBLNN_SET_SMALL_VALUE( bias )
+    LIBLNN_SET_SMALL_VALUE( nhwc )
+    LIBLNN_SET_SMALL_VALUE( relu_mask )
+    LIBLNN_SET_SMALL_VALUE( in_place )
+    LIBLNN_SET_SMALL_VALUE( checkpoint )
+    LIBLNN_SET_SMALL_VALUE( bf16 )
+    LIBLNN_SET_SMALL_VALUE( fused_block )
+    LIBLNN_SET_SMALL_VALUE( batchnorm )
+    LIBLNN_SET_SMALL_VALUE( megakernel )
+    LIBLNN_SET_SMALL_VALUE( quantize )
     LIBLNN_SET_SMALL_VALUE( debug_mode )
     std::string engine_name;
     version_t engine_version;
@@ -74,6 +111,7 @@ namespace liblnn {
     unsigned int device_index;
     bool validation;
     std::string dump_file;
+    std::string tuning_file;
     std::string train_data;
     std::string train_label;
     std::string eval_data;
@@ -82,6 +120,24 @@ namespace liblnn {
     unsigned int hidden_width;
     unsigned int c1_channels;
     unsigned int c2_channels;
+    float clip_norm;
+    unsigned int seed;
+    float dropout;
+    unsigned int residual_blocks;
+    float leaky_slope;
+    bool separable;
+    bool strided;
+    bool global_pool;
+    bool bias;
+    bool nhwc;
+    bool relu_mask;
+    bool in_place;
+    bool checkpoint;
+    bool bf16;
+    bool fused_block;
+    bool batchnorm;
+    bool megakernel;
+    bool quantize;
     bool debug_mode;
   };
   configs_t parse_configs( int argc, const char *argv[] );
@@ -27,6 +27,7 @@ SOFTWARE.
 #include <vulkan/vulkan.hpp>
 #include <liblnn/device_props.h>
 #include <liblnn/buffer_view.h>
+#include <liblnn/tensor_layout.h>
 namespace liblnn {
   class data_source {
   public:
@@ -44,6 +45,7 @@ namespace liblnn {
     virtual uint32_t get_image_height() const = 0;
     virtual uint32_t get_image_channel() const = 0;
     virtual uint32_t get_label_width() const = 0;
+    virtual tensor_layout get_layout() const { return tensor_layout::nchw; }
   };
 }
 
@@ -25,17 +25,29 @@ SOFTWARE.
 #include <memory>
 #include <vulkan/vulkan.hpp>
 #include <liblnn/setter.h>
+#include <liblnn/tuning.h>
 namespace liblnn {
   struct device_props {
-    device_props() {}
+    device_props() : subgroup_size_control( false ) {}
     LIBLNN_SET_LARGE_VALUE( props ) 
     LIBLNN_SET_LARGE_VALUE( props2 ) 
     LIBLNN_SET_LARGE_VALUE( subgroup_props ) 
+    LIBLNN_SET_LARGE_VALUE( subgroup_size_control_props ) 
+    LIBLNN_SET_LARGE_VALUE( subgroup_size_control_features ) 
+    LIBLNN_SET_LARGE_VALUE( required_subgroup_size ) 
+    LIBLNN_SET_SMALL_VALUE( subgroup_size_control ) 
+    LIBLNN_SET_LARGE_VALUE( tuning ) 
     vk::PhysicalDeviceProperties props;
     vk::PhysicalDeviceProperties2 props2;
     vk::PhysicalDeviceSubgroupProperties subgroup_props;
+    vk::PhysicalDeviceSubgroupSizeControlPropertiesEXT subgroup_size_control_props;
+    vk::PhysicalDeviceSubgroupSizeControlFeaturesEXT subgroup_size_control_features;
+    vk::PipelineShaderStageRequiredSubgroupSizeCreateInfoEXT required_subgroup_size;
+    bool subgroup_size_control;
+    std::shared_ptr< tuning_db > tuning;
   };
   device_props get_device_props( const vk::PhysicalDevice &physical_device );
+  bool is_subgroup_size_control_available( const vk::PhysicalDevice &physical_device );
 }
 #endif
 
@@ -49,9 +49,18 @@ namespace liblnn {
   struct unable_to_load_file : public std::runtime_error {
     unable_to_load_file() : std::runtime_error( "unable_to_load_file" ) {}
   };
+  struct timestamp_is_not_available : public std::runtime_error {
+    timestamp_is_not_available() : std::runtime_error( "timestamp_is_not_available" ) {}
+  };
   struct corrupted_file : public std::runtime_error {
     corrupted_file() : std::runtime_error( "corrupted_file" ) {}
   };
+  struct unsupported_layout : public std::runtime_error {
+    unsupported_layout() : std::runtime_error( "unsupported_layout" ) {}
+  };
+  struct unsupported_checkpoint : public std::runtime_error {
+    unsupported_checkpoint() : std::runtime_error( "unsupported_checkpoint" ) {}
+  };
 }
 
 #endif
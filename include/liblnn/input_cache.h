@@ -32,7 +32,8 @@ namespace liblnn {
     input_cache(
       std::shared_ptr< VmaAllocator > allocator,
       std::shared_ptr< data_source > source_,
-      uint32_t
+      uint32_t,
+      tensor_layout layout_ = tensor_layout::nchw
     );
     input_cache( const input_cache& ) = delete;
     input_cache( input_cache&& ) = delete;
@@ -43,6 +44,7 @@ namespace liblnn {
     virtual uint32_t get_image_height() const { return source->get_image_height(); }
     virtual uint32_t get_image_channel() const { return source->get_image_channel(); }
     virtual uint32_t get_label_width() const { return source->get_label_width(); }
+    virtual tensor_layout get_layout() const { return layout; }
     void operator()(
       vk::CommandBuffer&,
       const std::shared_ptr< vk::Device >&,
@@ -57,6 +59,7 @@ namespace liblnn {
     std::shared_ptr< buffer< float > > labels;
     uint32_t cache_count;
     uint32_t current_image;
+    tensor_layout layout;
   };
 }
 #endif
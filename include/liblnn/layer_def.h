@@ -29,10 +29,11 @@ SOFTWARE.
 #include <liblnn/setter.h>
 #include <liblnn/buffer.h>
 #include <liblnn/buffer_view.h>
+#include <liblnn/tuning.h>
 #include <glm/vec4.hpp>
 namespace liblnn {
   struct layer_def {
-    layer_def() : dispatch_size{ 1, 1, 1 }, batch_count( 1 ), clear_input_grad( false ) {}
+    layer_def() : dispatch_size{ 1, 1, 1 }, batch_count( 1 ) {}
     layer_def &set_dispatch_size( uint32_t x, uint32_t y, uint32_t z ) {
       dispatch_size[ 0 ] = x;
       dispatch_size[ 1 ] = y;
@@ -48,11 +49,23 @@ namespace liblnn {
     LIBLNN_SET_LARGE_VALUE( input_grad )
     LIBLNN_SET_LARGE_VALUE( output_grad )
     LIBLNN_SET_LARGE_VALUE( teacher_value )
+    LIBLNN_SET_LARGE_VALUE( weight_grad )
+    LIBLNN_SET_LARGE_VALUE( bias )
+    LIBLNN_SET_LARGE_VALUE( mask )
+    LIBLNN_SET_LARGE_VALUE( shortcut )
+    LIBLNN_SET_LARGE_VALUE( depthwise_weight )
+    LIBLNN_SET_LARGE_VALUE( depthwise_value )
+    LIBLNN_SET_LARGE_VALUE( bias_grad )
+    LIBLNN_SET_LARGE_VALUE( quantized_weight )
+    LIBLNN_SET_LARGE_VALUE( weight_scale )
+    LIBLNN_SET_LARGE_VALUE( activation_range )
+    LIBLNN_SET_LARGE_VALUE( output_weight )
+    LIBLNN_SET_LARGE_VALUE( scratch )
     LIBLNN_SET_LARGE_VALUE( pipeline )
     LIBLNN_SET_LARGE_VALUE( descriptor_set )
     LIBLNN_SET_LARGE_VALUE( pipeline_layout )
     LIBLNN_SET_LARGE_VALUE( descriptor_set_layout )
-    LIBLNN_SET_SMALL_VALUE( clear_input_grad )
+    LIBLNN_SET_LARGE_VALUE( tuning )
     std::array< uint32_t, 3 > dispatch_size;
     uint32_t batch_count;
     std::shared_ptr< vk::ShaderModule > module;
@@ -62,11 +75,23 @@ namespace liblnn {
     buffer_view< float > input_grad;
     buffer_view< float > output_grad;
     buffer_view< float > teacher_value;
+    buffer_view< float > weight_grad;
+    buffer_view< glm::vec4 > bias;
+    buffer_view< float > mask;
+    buffer_view< float > shortcut;
+    buffer_view< glm::vec4 > depthwise_weight;
+    buffer_view< float > depthwise_value;
+    buffer_view< float > bias_grad;
+    buffer_view< float > quantized_weight;
+    buffer_view< float > weight_scale;
+    buffer_view< float > activation_range;
+    buffer_view< glm::vec4 > output_weight;
+    buffer_view< float > scratch;
     std::shared_ptr< vk::Pipeline > pipeline;
     std::shared_ptr< vk::DescriptorSet > descriptor_set;
     std::shared_ptr< vk::PipelineLayout > pipeline_layout;
     std::shared_ptr< vk::DescriptorSetLayout > descriptor_set_layout;
-    bool clear_input_grad;
+    tuning_entry tuning;
   };
 }
 #endif
@@ -68,7 +68,7 @@ namespace liblnn {
     std::mt19937 gen;
   };
 
-  std::tuple< std::shared_ptr< buffer< float > >, uint32_t >
+  std::tuple< std::shared_ptr< buffer< float > >, uint32_t, uint32_t, uint32_t >
   load_mnist_images(
     const std::shared_ptr< VmaAllocator > &allocator,
     const std::string &filename
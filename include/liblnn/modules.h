@@ -45,6 +45,30 @@ namespace liblnn {
     std::shared_ptr< vk::ShaderModule > add_forward;
     std::shared_ptr< vk::ShaderModule > add_backward;
     std::shared_ptr< vk::ShaderModule > softmax_combined;
+    std::shared_ptr< vk::ShaderModule > grad_norm;
+    std::shared_ptr< vk::ShaderModule > clipped_update;
+    std::shared_ptr< vk::ShaderModule > batchnorm_forward;
+    std::shared_ptr< vk::ShaderModule > batchnorm_backward;
+    std::shared_ptr< vk::ShaderModule > batchnorm_fold;
+    std::shared_ptr< vk::ShaderModule > dropout_forward;
+    std::shared_ptr< vk::ShaderModule > dropout_backward;
+    std::shared_ptr< vk::ShaderModule > leaky_relu_forward;
+    std::shared_ptr< vk::ShaderModule > leaky_relu_backward;
+    std::shared_ptr< vk::ShaderModule > pointwise_forward;
+    std::shared_ptr< vk::ShaderModule > pointwise_backward;
+    std::shared_ptr< vk::ShaderModule > pointwise2_backward;
+    std::shared_ptr< vk::ShaderModule > separable_forward;
+    std::shared_ptr< vk::ShaderModule > avgpooling_forward;
+    std::shared_ptr< vk::ShaderModule > avgpooling_backward;
+    std::shared_ptr< vk::ShaderModule > quantize_weight;
+    std::shared_ptr< vk::ShaderModule > activation_range;
+    std::shared_ptr< vk::ShaderModule > affine_forward_int8;
+    std::shared_ptr< vk::ShaderModule > conv_forward_int8;
+    std::shared_ptr< vk::ShaderModule > mlp_step;
+    std::shared_ptr< vk::ShaderModule > relu_mask_forward;
+    std::shared_ptr< vk::ShaderModule > relu_mask_backward;
+    std::shared_ptr< vk::ShaderModule > conv_block_forward;
+    std::shared_ptr< vk::ShaderModule > maxpooling_relu_backward;
   };
 }
 #endif
@@ -23,21 +23,31 @@ SOFTWARE.
 */
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <array>
 #include <string>
 #include <functional>
+#include <tuple>
 #include <vector>
 #include <boost/container/flat_map.hpp>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.hpp>
 #include <glm/vec4.hpp>
 #include <liblnn/buffer.h>
+#include <liblnn/config.h>
 #include <liblnn/device_props.h>
 #include <liblnn/modules.h>
 #include <liblnn/data_source.h>
 #include <liblnn/layer.h>
+#include <liblnn/pipeline.h>
 namespace liblnn {
+  struct block_layers {
+    buffer_view< float > output;
+    buffer_view< float > output_grad;
+    std::vector< std::shared_ptr< layer > > forward;
+    std::vector< std::shared_ptr< layer > > backward;
+  };
   class network {
   public:
     network(
@@ -59,11 +69,51 @@ namespace liblnn {
     void evaluate();
     void dump( const std::string &filename );
     void restore( const std::string &filename );
-    void init();
+    void init( uint64_t seed = 0u );
   protected:
     void fill( bool, bool );
     void check();
-    std::vector< std::pair< std::shared_ptr< liblnn::buffer< glm::vec4 > >, uint32_t > > weights;
+    buffer_view< float > deferred_grad( const std::shared_ptr< liblnn::buffer< glm::vec4 > > &weight, float alpha, bool bf16 = false );
+    void build_clipping();
+    std::pair< buffer_view< float >, buffer_view< float > > quantize_weight(
+      const std::shared_ptr< liblnn::buffer< glm::vec4 > > &weight,
+      uint32_t channels,
+      uint32_t channel_stride,
+      uint32_t element_stride,
+      uint32_t elements
+    );
+    buffer_view< float > calibrate_range( const buffer_view< float > &value );
+    buffer_view< float > dropout_mask( size_t size );
+    buffer_view< float > relu_mask( size_t size );
+    block_layers build_residual_block(
+      const std::string &name,
+      const buffer_view< float > &input_value,
+      const buffer_view< float > &input_grad,
+      uint32_t width,
+      uint32_t height,
+      uint32_t channels,
+      float alpha,
+      tensor_layout layout = tensor_layout::nchw,
+      bool bf16 = false
+    );
+    block_layers build_separable_conv(
+      const std::string &name,
+      const buffer_view< float > &input_value,
+      const buffer_view< float > &input_grad,
+      const buffer_view< float > &output_value,
+      const buffer_view< float > &output_grad,
+      uint32_t width,
+      uint32_t height,
+      uint32_t input_channels,
+      uint32_t output_channels,
+      tensor_layout layout = tensor_layout::nchw
+    );
+    void clip( vk::CommandBuffer &command_buffer ) const;
+    void calibrate( size_t batches );
+    void quantize();
+    void evaluate_quantized();
+    void dump_quantized( const std::string &filename );
+    std::vector< std::tuple< std::shared_ptr< liblnn::buffer< glm::vec4 > >, uint32_t, init_type > > weights;
     std::shared_ptr< vk::CommandPool > command_pool;
     std::shared_ptr< vk::Device > device;
     std::shared_ptr< vk::Queue > queue;
@@ -84,6 +134,15 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > output_activation_output;
     std::shared_ptr< liblnn::buffer< float > > output_activation_output_eval;
     std::shared_ptr< liblnn::buffer< float > > error_out;
+    float max_grad_norm;
+    std::vector< std::tuple< std::shared_ptr< liblnn::buffer< glm::vec4 > >, std::shared_ptr< liblnn::buffer< float > >, float > > weight_grads;
+    std::shared_ptr< liblnn::buffer< float > > grad_norm;
+    std::vector< std::shared_ptr< layer > > calibration;
+    std::vector< std::shared_ptr< layer > > quantization;
+    std::vector< std::shared_ptr< liblnn::buffer< float > > > activation_ranges;
+    std::vector< std::shared_ptr< liblnn::buffer< float > > > quantized_model;
+    std::vector< std::shared_ptr< layer > > clipping;
+    std::vector< std::shared_ptr< liblnn::buffer< float > > > masks;
   };
   class simple : public network {
   public:
@@ -100,6 +159,7 @@ namespace liblnn {
       const liblnn::modules &mods,
       size_t hidden_width_,
       size_t batch_size_,
+      bool megakernel_,
       bool debug_
     );
   private:
@@ -108,6 +168,7 @@ namespace liblnn {
     size_t image_channels;
     size_t hidden_width;
     size_t output_width;
+    bool megakernel;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > hidden_weight;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > output_weight;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_output;
@@ -118,6 +179,7 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > output_affine_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_grad;
+    std::shared_ptr< liblnn::buffer< float > > mlp_scratch;
     std::shared_ptr< layer > init_hidden_weight;
     std::shared_ptr< layer > init_output_weight;
     std::shared_ptr< layer > hidden_affine1;
@@ -134,6 +196,8 @@ namespace liblnn {
     std::shared_ptr< layer > hidden_activation_backward;
     std::shared_ptr< layer > hidden_affine_backward1;
     std::shared_ptr< layer > hidden_affine_backward2;
+    std::shared_ptr< layer > mlp_step1;
+    std::shared_ptr< layer > mlp_step2;
   };
   class conv3 : public network {
   public:
@@ -393,7 +457,6 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > output_affine_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_grad;
-    std::shared_ptr< liblnn::buffer< float > > c1_mp_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation2_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_conv2_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation1_grad;
@@ -421,7 +484,6 @@ namespace liblnn {
     std::shared_ptr< layer > hidden_activation_backward;
     std::shared_ptr< layer > hidden_affine_backward;
     std::shared_ptr< layer > c1_mp_backward;
-    std::shared_ptr< layer > c1_activation2_backward;
     std::shared_ptr< layer > c1_conv2_bp_backward;
     std::shared_ptr< layer > c1_conv2_update_backward;
     std::shared_ptr< layer > c1_activation1_backward;
@@ -477,7 +539,6 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > output_affine_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_grad;
-    std::shared_ptr< liblnn::buffer< float > > c1_mp_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation3_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_conv3_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation2_grad;
@@ -509,7 +570,6 @@ namespace liblnn {
     std::shared_ptr< layer > hidden_activation_backward;
     std::shared_ptr< layer > hidden_affine_backward;
     std::shared_ptr< layer > c1_mp_backward;
-    std::shared_ptr< layer > c1_activation3_backward;
     std::shared_ptr< layer > c1_conv3_bp_backward;
     std::shared_ptr< layer > c1_conv3_update_backward;
     std::shared_ptr< layer > c1_activation2_backward;
@@ -576,12 +636,10 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > output_affine_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_grad;
-    std::shared_ptr< liblnn::buffer< float > > c2_mp_grad;
     std::shared_ptr< liblnn::buffer< float > > c2_activation2_grad;
     std::shared_ptr< liblnn::buffer< float > > c2_conv2_grad;
     std::shared_ptr< liblnn::buffer< float > > c2_activation1_grad;
     std::shared_ptr< liblnn::buffer< float > > c2_conv1_grad;
-    std::shared_ptr< liblnn::buffer< float > > c1_mp_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation2_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_conv2_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_activation1_grad;
@@ -616,14 +674,12 @@ namespace liblnn {
     std::shared_ptr< layer > hidden_activation_backward;
     std::shared_ptr< layer > hidden_affine_backward;
     std::shared_ptr< layer > c2_mp_backward;
-    std::shared_ptr< layer > c2_activation2_backward;
     std::shared_ptr< layer > c2_conv2_bp_backward;
     std::shared_ptr< layer > c2_conv2_update_backward;
     std::shared_ptr< layer > c2_activation1_backward;
     std::shared_ptr< layer > c2_conv1_bp_backward;
     std::shared_ptr< layer > c2_conv1_update_backward;
     std::shared_ptr< layer > c1_mp_backward;
-    std::shared_ptr< layer > c1_activation2_backward;
     std::shared_ptr< layer > c1_conv2_bp_backward;
     std::shared_ptr< layer > c1_conv2_update_backward;
     std::shared_ptr< layer > c1_activation1_backward;
@@ -645,11 +701,7 @@ namespace liblnn {
       const std::shared_ptr< data_source > &tin_,
       const std::shared_ptr< data_source > &ein_,
       const liblnn::modules &mods,
-      size_t c1_channels_,
-      size_t c2_channels_,
-      size_t hidden_width_,
-      size_t batch_size_,
-      bool debug_
+      const configs_t &config
     );
   private:
     size_t image_width;
@@ -663,6 +715,9 @@ namespace liblnn {
     size_t c2_channels;
     size_t hidden_width;
     size_t output_width;
+    bool batchnorm;
+    float dropout;
+    float leaky_slope;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_conv1_weight;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_conv2_weight;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_conv3_weight;
@@ -671,6 +726,18 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< glm::vec4 > > c2_conv3_weight;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > hidden_weight;
     std::shared_ptr< liblnn::buffer< glm::vec4 > > output_weight;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > hidden_bias;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > output_bias;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_bn1_weight;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c2_bn1_weight;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_conv1_folded_weight;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c2_conv1_folded_weight;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c1_conv1_bias;
+    std::shared_ptr< liblnn::buffer< glm::vec4 > > c2_conv1_bias;
+    std::shared_ptr< liblnn::buffer< float > > c1_bn1_output;
+    std::shared_ptr< liblnn::buffer< float > > c2_bn1_output;
+    std::shared_ptr< liblnn::buffer< float > > c1_bn1_grad;
+    std::shared_ptr< liblnn::buffer< float > > c2_bn1_grad;
     std::shared_ptr< liblnn::buffer< float > > c1_conv1_output;
     std::shared_ptr< liblnn::buffer< float > > c1_activation1_output;
     std::shared_ptr< liblnn::buffer< float > > c1_conv2_output;
@@ -678,19 +745,21 @@ namespace liblnn {
     std::shared_ptr< liblnn::buffer< float > > c1_conv3_output;
     std::shared_ptr< liblnn::buffer< float > > c1_activation3_output;
     std::shared_ptr< liblnn::buffer< float > > c1_mp_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_conv1_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_activation1_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_conv2_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_activation2_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_conv3_output;
-    std::shared_ptr< liblnn::buffer< float > > c2_activation3_output;
+    buffer_view< float > c2_conv1_output;
+    buffer_view< float > c2_activation1_output;
+    buffer_view< float > c2_conv2_output;
+    buffer_view< float > c2_activation2_output;
+    buffer_view< float > c2_conv3_output;
+    buffer_view< float > c2_activation3_output;
     std::shared_ptr< liblnn::buffer< float > > c2_mp_output;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_output;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_output;
+    std::shared_ptr< liblnn::buffer< float > > hidden_dropout_output;
     std::shared_ptr< liblnn::buffer< float > > output_affine_output;
     std::shared_ptr< liblnn::buffer< float > > softmax_grad;
     std::shared_ptr< liblnn::buffer< float > > output_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > output_affine_grad;
+    std::shared_ptr< liblnn::buffer< float > > hidden_dropout_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_activation_grad;
     std::shared_ptr< liblnn::buffer< float > > hidden_affine_grad;
     std::shared_ptr< liblnn::buffer< float > > c2_mp_grad;
@@ -716,22 +785,28 @@ namespace liblnn {
     std::shared_ptr< layer > c1_conv3;
     std::shared_ptr< layer > c1_activation3;
     std::shared_ptr< layer > c1_mp;
+    std::shared_ptr< layer > c1_block;
     std::shared_ptr< layer > c2_conv1;
     std::shared_ptr< layer > c2_activation1;
     std::shared_ptr< layer > c2_conv2;
     std::shared_ptr< layer > c2_activation2;
     std::shared_ptr< layer > c2_conv3;
     std::shared_ptr< layer > c2_activation3;
+    std::vector< block_layers > c2_residual;
+    block_layers c2_separable;
     std::shared_ptr< layer > c2_mp;
     std::shared_ptr< layer > hidden_affine;
     std::shared_ptr< layer > hidden_activation;
+    std::shared_ptr< layer > hidden_dropout;
     std::shared_ptr< layer > output_affine;
+    std::shared_ptr< layer > output_affine_eval;
     std::shared_ptr< layer > output_activation;
     std::shared_ptr< layer > output_activation3;
     std::shared_ptr< layer > error1;
     std::shared_ptr< layer > error2;
     std::shared_ptr< layer > output_activation_backward;
     std::shared_ptr< layer > output_affine_backward;
+    std::shared_ptr< layer > hidden_dropout_backward;
     std::shared_ptr< layer > hidden_activation_backward;
     std::shared_ptr< layer > hidden_affine_backward;
     std::shared_ptr< layer > c2_mp_backward;
@@ -756,6 +831,23 @@ namespace liblnn {
     std::shared_ptr< layer > c1_conv1_update_backward_2;
     std::shared_ptr< layer > c1_conv1_bp_backward_1;
     std::shared_ptr< layer > c1_conv1_update_backward_1;
+    std::shared_ptr< layer > c1_bn1;
+    std::shared_ptr< layer > c1_bn1_recompute;
+    std::shared_ptr< layer > c1_bn1_backward;
+    std::shared_ptr< layer > c1_bn1_fold;
+    std::shared_ptr< layer > c1_conv1_eval;
+    std::shared_ptr< layer > c2_bn1;
+    std::shared_ptr< layer > c2_bn1_backward;
+    std::shared_ptr< layer > c2_bn1_fold;
+    std::shared_ptr< layer > c2_conv1_eval;
+    std::shared_ptr< layer > c1_conv1_int8;
+    std::shared_ptr< layer > c1_conv2_int8;
+    std::shared_ptr< layer > c1_conv3_int8;
+    std::shared_ptr< layer > c2_conv1_int8;
+    std::shared_ptr< layer > c2_conv2_int8;
+    std::shared_ptr< layer > c2_conv3_int8;
+    std::shared_ptr< layer > hidden_affine_int8;
+    std::shared_ptr< layer > output_affine_int8;
   };
 }
 #endif
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <array>
 #include <vector>
 #include <utility>
+#include <cstdint>
 #include <vulkan/vulkan.hpp>
 #include <glm/vec4.hpp>
 #include <liblnn/layer.h>
@@ -32,7 +33,17 @@ SOFTWARE.
 #include <liblnn/device_props.h>
 #include <liblnn/buffer.h>
 #include <liblnn/buffer_view.h>
+#include <liblnn/tensor_layout.h>
 namespace liblnn {
+  enum class init_type : uint32_t {
+    he = 0,
+    xavier = 1,
+    batchnorm = 2,
+    zero = 3
+  };
+  uint32_t get_subgroup_size( const device_props &props );
+  vk::PipelineShaderStageCreateInfo get_shader_stage( const device_props &props, uint32_t local_size = 0u );
+  std::array< uint32_t, 2 > get_dispatch_size( const device_props &props, uint32_t group_count );
   layer create_init_pipeline(
     const std::shared_ptr< vk::Device > &device,
     const modules &mods,
@@ -40,7 +51,10 @@ namespace liblnn {
     const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
     const device_props &props,
     const buffer_view< glm::vec4 > &weight,
-    uint32_t input_size
+    uint32_t input_size,
+    init_type type = init_type::he,
+    uint64_t seed = 0u,
+    uint32_t stream = 0u
   );
   layer create_affine_forward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -53,6 +67,45 @@ namespace liblnn {
     const buffer_view< glm::vec4 > &weight,
     size_t batch_size
   );
+  layer create_affine_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
+    size_t batch_size
+  );
+  layer create_affine_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    size_t batch_size
+  );
+  layer create_affine_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    size_t batch_size
+  );
   layer create_affine_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
     const modules &mods,
@@ -62,6 +115,9 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &bias_grad,
     const buffer_view< float > &input_grad,
     const buffer_view< float > &output_grad,
     size_t batch_size
@@ -132,7 +188,8 @@ namespace liblnn {
     uint32_t filter_width,
     uint32_t filter_height,
     uint32_t filter_xstride,
-    uint32_t filter_ystride
+    uint32_t filter_ystride,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_max_pooling_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -151,7 +208,53 @@ namespace liblnn {
     uint32_t filter_width,
     uint32_t filter_height,
     uint32_t filter_xstride,
-    uint32_t filter_ystride
+    uint32_t filter_ystride,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_max_pooling_relu_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &mask,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    float slope,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv_forward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -162,6 +265,7 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
     uint32_t output_width,
     uint32_t output_height,
     uint32_t output_channels,
@@ -173,7 +277,12 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    bool use_activation = false,
+    float slope = 0.01f,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -196,7 +305,64 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &bias_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv2_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -220,7 +386,38 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv2_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    const buffer_view< float > &shortcut_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv_straight_forward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -241,7 +438,31 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv_straight_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t filter_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv_straight_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -252,6 +473,7 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
     const buffer_view< float > &output_grad,
     uint32_t output_width,
     uint32_t output_height,
@@ -263,7 +485,8 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
   );
   layer create_conv2_straight_backward_pipeline(
     const std::shared_ptr< vk::Device > &device,
@@ -286,7 +509,369 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_grad_norm_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &norm,
+    uint32_t slot
+  );
+  layer create_clipped_update_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &norm,
+    float max_norm,
+    float alpha
+  );
+  layer create_batchnorm_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    uint32_t width,
+    uint32_t channels,
+    uint32_t batch_size,
+    bool training,
+    tensor_layout layout = tensor_layout::nchw,
+    bool recompute = false
+  );
+  layer create_batchnorm_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t channels,
+    uint32_t batch_size,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_batchnorm_fold_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< glm::vec4 > &source_weight,
+    const buffer_view< glm::vec4 > &batchnorm,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
+    uint32_t channels
+  );
+  layer create_dropout_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &mask,
+    float rate,
+    uint64_t seed
+  );
+  layer create_dropout_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &mask,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    float rate
+  );
+  layer create_add_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &shortcut,
+    const buffer_view< float > &output_value
+  );
+  layer create_leaky_relu_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    float slope = 0.01f
+  );
+  layer create_leaky_relu_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    float slope = 0.01f
+  );
+  layer create_pointwise_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
+    uint32_t width,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t input_channels,
+    bool use_activation = false,
+    float slope = 0.01f,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_pointwise_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t input_channels,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_pointwise_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &bias_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t input_channels,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_pointwise2_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t input_channels,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_separable_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &depthwise_weight,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &depthwise_value,
+    uint32_t width,
+    uint32_t height,
+    uint32_t input_channels,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_conv_block_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &depthwise_weight,
+    const buffer_view< glm::vec4 > &output_weight,
+    uint32_t width,
+    uint32_t height,
+    uint32_t input_channels,
+    uint32_t channels,
+    uint32_t batch_size,
+    float slope,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_global_average_pooling_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    uint32_t width,
+    uint32_t height,
+    uint32_t channels,
+    uint32_t batch_size,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_global_average_pooling_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t height,
+    uint32_t channels,
+    uint32_t batch_size,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_quantize_weight_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &quantized_weight,
+    const buffer_view< float > &weight_scale,
+    uint32_t channels,
+    uint32_t channel_stride,
+    uint32_t element_stride,
+    uint32_t elements
+  );
+  layer create_activation_range_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &activation_range,
+    uint32_t slot
+  );
+  layer create_affine_forward_int8_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &quantized_weight,
+    const buffer_view< float > &weight_scale,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &activation_range,
+    uint32_t slot,
+    size_t batch_size
+  );
+  layer create_conv_forward_int8_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &quantized_weight,
+    const buffer_view< float > &weight_scale,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &activation_range,
+    uint32_t slot,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t input_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    bool depthwise,
+    bool use_activation = false,
+    float slope = 0.01f,
+    uint32_t input_width = 0u,
+    uint32_t input_height = 0u,
+    tensor_layout layout = tensor_layout::nchw
+  );
+  layer create_mlp_step_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &teacher_value,
+    const buffer_view< glm::vec4 > &output_weight,
+    const buffer_view< float > &scratch,
+    size_t batch_size
+  );
+  layer create_relu_mask_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &mask
+  );
+  layer create_relu_mask_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &mask,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad
   );
 }
 #endif
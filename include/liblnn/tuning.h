@@ -0,0 +1,94 @@
+#ifndef LIBLNN_INCLUDE_TUNING_H
+#define LIBLNN_INCLUDE_TUNING_H
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <memory>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <vulkan/vulkan.hpp>
+#include <liblnn/setter.h>
+namespace liblnn {
+  struct device_props;
+  class tuning_db;
+  // local size and tile ( outputs per invocation ) of a kernel
+  using tuning_parameters = std::pair< uint32_t, uint32_t >;
+  struct tuning_entry {
+    tuning_entry() : local_size( 0u ), tile( 1u ) {}
+    LIBLNN_SET_LARGE_VALUE( db )
+    LIBLNN_SET_LARGE_VALUE( key )
+    LIBLNN_SET_SMALL_VALUE( local_size )
+    LIBLNN_SET_SMALL_VALUE( tile )
+    std::shared_ptr< tuning_db > db;
+    std::string key;
+    uint32_t local_size;
+    uint32_t tile;
+  };
+  class tuning_db {
+  public:
+    tuning_db() : candidate( 0u ), candidate_count( 1u ), next_query( 0u ), query_count( 0u ), timestamp_period( 1.f ) {}
+    void load( const std::string &filename );
+    void save( const std::string &filename ) const;
+    tuning_parameters get_parameters( const std::string &key, const std::vector< tuning_parameters > &candidates, const tuning_parameters &default_parameters );
+    uint32_t get_candidate_count() const { return candidate_count; }
+    void start_profiling(
+      const std::shared_ptr< vk::Device > &device,
+      const std::shared_ptr< vk::Queue > &queue,
+      const std::shared_ptr< vk::CommandPool > &command_pool,
+      const device_props &props,
+      uint32_t query_count
+    );
+    void set_candidate( uint32_t index );
+    void collect();
+    void stop_profiling();
+    bool is_profiling() const { return bool( query_pool ); }
+    uint32_t begin( vk::CommandBuffer &command_buffer, const std::string &key, const tuning_parameters &parameters );
+    void end( vk::CommandBuffer &command_buffer, uint32_t query );
+  private:
+    std::unordered_map< std::string, std::pair< tuning_parameters, double > > best;
+    std::vector< std::pair< std::string, tuning_parameters > > queries;
+    std::shared_ptr< vk::Device > device;
+    std::shared_ptr< vk::Queue > queue;
+    std::shared_ptr< vk::CommandPool > command_pool;
+    std::shared_ptr< vk::QueryPool > query_pool;
+    uint32_t candidate;
+    uint32_t candidate_count;
+    uint32_t next_query;
+    uint32_t query_count;
+    float timestamp_period;
+  };
+  std::shared_ptr< tuning_db > load_tuning_db( const std::string &filename );
+  tuning_entry get_tuning_entry(
+    const device_props &props,
+    const std::string &kernel,
+    const std::vector< uint32_t > &shape,
+    uint32_t default_size,
+    uint32_t max_size,
+    const std::vector< uint32_t > &tiles = std::vector< uint32_t >{ 1u }
+  );
+}
+
+#endif
+
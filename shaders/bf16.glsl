@@ -0,0 +1,24 @@
+#ifndef LIBLNN_SHADERS_BF16_GLSL
+#define LIBLNN_SHADERS_BF16_GLSL
+
+// weight_grad must be declared as uint[] and bf16_grad as a specialization constant before inclusion
+
+#include "bf16_pack.glsl"
+
+float load_weight_grad( uint index ) {
+  if( bf16_grad )
+    return bf16_unpack( weight_grad[ index / 2 ], index );
+  else
+    return uintBitsToFloat( weight_grad[ index ] );
+}
+
+void store_weight_grad( uint index, float value ) {
+  weight_grad[ index ] = floatBitsToUint( value );
+}
+
+// index must be even, the invocation owns both index and index + 1
+void store_weight_grad_pair( uint index, float low, float high ) {
+  weight_grad[ index / 2 ] = bf16_pack( low, high );
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef LIBLNN_SHADERS_BF16_PACK_GLSL
+#define LIBLNN_SHADERS_BF16_PACK_GLSL
+
+// packed tensors hold element 2n in the low and element 2n + 1 in the high half of word n
+
+uint bf16_round( float value ) {
+  const uint bits = floatBitsToUint( value );
+  return ( bits + 0x7FFFu + ( ( bits >> 16 ) & 1u ) ) >> 16;
+}
+
+float bf16_expand( uint value ) {
+  return uintBitsToFloat( value << 16 );
+}
+
+float bf16_unpack( uint word, uint index ) {
+  return bf16_expand( ( word >> ( ( index % 2 ) * 16 ) ) & 0xFFFFu );
+}
+
+uint bf16_pack( float low, float high ) {
+  return bf16_round( low ) | ( bf16_round( high ) << 16 );
+}
+
+#endif
@@ -17,3 +17,26 @@ ${GLSLC} conv_straight_backward.comp -o conv_straight_backward.comp.spv --target
 ${GLSLC} conv2_straight_backward.comp -o conv2_straight_backward.comp.spv --target-env=vulkan1.1
 ${GLSLC} maxpooling_forward.comp -o maxpooling_forward.comp.spv --target-env=vulkan1.1
 ${GLSLC} maxpooling_backward.comp -o maxpooling_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} grad_norm.comp -o grad_norm.comp.spv --target-env=vulkan1.1
+${GLSLC} clipped_update.comp -o clipped_update.comp.spv --target-env=vulkan1.1
+${GLSLC} batchnorm_forward.comp -o batchnorm_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} batchnorm_backward.comp -o batchnorm_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} batchnorm_fold.comp -o batchnorm_fold.comp.spv --target-env=vulkan1.1
+${GLSLC} dropout_forward.comp -o dropout_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} dropout_backward.comp -o dropout_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} add_forward.comp -o add_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} pointwise_forward.comp -o pointwise_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} pointwise_backward.comp -o pointwise_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} pointwise2_backward.comp -o pointwise2_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} separable_forward.comp -o separable_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} avgpooling_forward.comp -o avgpooling_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} avgpooling_backward.comp -o avgpooling_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} quantize_weight.comp -o quantize_weight.comp.spv --target-env=vulkan1.1
+${GLSLC} activation_range.comp -o activation_range.comp.spv --target-env=vulkan1.1
+${GLSLC} affine_forward_int8.comp -o affine_forward_int8.comp.spv --target-env=vulkan1.1
+${GLSLC} conv_forward_int8.comp -o conv_forward_int8.comp.spv --target-env=vulkan1.1
+${GLSLC} mlp_step.comp -o mlp_step.comp.spv --target-env=vulkan1.1
+${GLSLC} relu_mask_forward.comp -o relu_mask_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} relu_mask_backward.comp -o relu_mask_backward.comp.spv --target-env=vulkan1.1
+${GLSLC} conv_block_forward.comp -o conv_block_forward.comp.spv --target-env=vulkan1.1
+${GLSLC} maxpooling_relu_backward.comp -o maxpooling_relu_backward.comp.spv --target-env=vulkan1.1
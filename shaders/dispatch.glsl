@@ -0,0 +1,26 @@
+#ifndef LIBLNN_SHADERS_DISPATCH_GLSL
+#define LIBLNN_SHADERS_DISPATCH_GLSL
+
+// layer::operator() splits the y and batch dimensions into dispatches the device can accept and passes the first group of each slice in group_offset_y and batch_offset
+
+layout(push_constant) uniform dispatch_constants {
+  uint batch_count;
+  uint batch_offset;
+  uint group_offset_y;
+};
+
+uint group_y() {
+  return gl_WorkGroupID.y + group_offset_y;
+}
+
+// get_dispatch_size folds group counts beyond the x limit into the y dimension
+
+uint flat_invocation_index() {
+  return gl_GlobalInvocationID.x + group_y() * gl_NumWorkGroups.x * gl_WorkGroupSize.x;
+}
+
+uint batch_index() {
+  return gl_WorkGroupID.z + batch_offset;
+}
+
+#endif
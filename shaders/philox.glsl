@@ -0,0 +1,29 @@
+#ifndef LIBLNN_SHADERS_PHILOX_GLSL
+#define LIBLNN_SHADERS_PHILOX_GLSL
+
+const uint PHILOX_M0 = 0xD2511F53u;
+const uint PHILOX_M1 = 0xCD9E8D57u;
+const uint PHILOX_W0 = 0x9E3779B9u;
+const uint PHILOX_W1 = 0xBB67AE85u;
+
+uvec4 philox_round( uvec4 counter, uvec2 key ) {
+  uint hi0, lo0, hi1, lo1;
+  umulExtended( PHILOX_M0, counter.x, hi0, lo0 );
+  umulExtended( PHILOX_M1, counter.z, hi1, lo1 );
+  return uvec4( hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0 );
+}
+
+uvec4 philox4x32( uvec4 counter, uvec2 key ) {
+  for( uint i = 0; i != 10; i++ ) {
+    counter = philox_round( counter, key );
+    key += uvec2( PHILOX_W0, PHILOX_W1 );
+  }
+  return counter;
+}
+
+vec4 philox_uniform( uvec4 counter, uvec2 key ) {
+  return ( vec4( philox4x32( counter, key ) >> 8 ) + 1.0 ) * ( 1.0 / 16777216.0 );
+}
+
+#endif
+
@@ -0,0 +1,11 @@
+#ifndef LIBLNN_SHADERS_SUBGROUP_REDUCTION_GLSL
+#define LIBLNN_SHADERS_SUBGROUP_REDUCTION_GLSL
+
+// subgroup_size must be declared as a specialization constant before inclusion
+// it is 0 unless the pipeline pins the subgroup size with VK_EXT_subgroup_size_control
+
+const uint workgroup_invocations = gl_WorkGroupSize.x * gl_WorkGroupSize.y * gl_WorkGroupSize.z;
+const bool single_subgroup = subgroup_size != 0 && workgroup_invocations <= subgroup_size;
+const bool two_level_reduction = subgroup_size != 0 && workgroup_invocations <= subgroup_size * subgroup_size;
+
+#endif
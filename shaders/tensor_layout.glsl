@@ -0,0 +1,24 @@
+#ifndef LIBLNN_SHADERS_TENSOR_LAYOUT_GLSL
+#define LIBLNN_SHADERS_TENSOR_LAYOUT_GLSL
+
+// channels_last must be declared as a specialization constant before inclusion
+
+uvec3 tensor_position( uint index, uint width, uint height, uint channels ) {
+  return channels_last ?
+    uvec3( index / channels % width, index / channels / width, index % channels ) :
+    uvec3( index % width, index / width % height, index / width / height );
+}
+
+int tensor_offset( int x, int y, int channel, uint width, uint height, uint channels ) {
+  return channels_last ?
+    channel + ( x + y * int( width ) ) * int( channels ) :
+    x + y * int( width ) + channel * int( width * height );
+}
+
+uint pixel_offset( uint pixel, uint channel, uint pixels, uint channels ) {
+  return channels_last ?
+    channel + pixel * channels :
+    pixel + channel * pixels;
+}
+
+#endif
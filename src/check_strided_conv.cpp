@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <vulkan/vulkan.hpp>
+#include <vk_mem_alloc.h>
+#include <glm/vec4.hpp>
+#include <liblnn/config.h>
+#include <liblnn/instance.h>
+#include <liblnn/device.h>
+#include <liblnn/command_buffer.h>
+#include <liblnn/modules.h>
+#include <liblnn/device_props.h>
+#include <liblnn/layer.h>
+#include <liblnn/pipeline_cache.h>
+#include <liblnn/descriptor_pool.h>
+#include <liblnn/allocator.h>
+#include <liblnn/buffer.h>
+#include <liblnn/buffer_view.h>
+#include <liblnn/pipeline.h>
+
+struct conv_case {
+  uint32_t input_width;
+  uint32_t input_height;
+  uint32_t output_width;
+  uint32_t output_height;
+  uint32_t xmargin;
+  uint32_t ymargin;
+};
+
+template< typename T >
+std::shared_ptr< liblnn::buffer< T > > create_buffer( const std::shared_ptr< VmaAllocator > &allocator, size_t size ) {
+  return std::shared_ptr< liblnn::buffer< T > >( new liblnn::buffer< T >( allocator, VMA_MEMORY_USAGE_GPU_TO_CPU,
+    vk::BufferCreateInfo()
+      .setSize( size * sizeof( T ) )
+      .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+  ) );
+}
+
+float max_error( const std::vector< float > &expected, const std::shared_ptr< float > &actual ) {
+  float error = 0.f;
+  for( size_t i = 0u; i != expected.size(); ++i )
+    error = std::max( error, std::abs( expected[ i ] - actual.get()[ i ] ) / ( 1.f + std::abs( expected[ i ] ) ) );
+  return error;
+}
+
+int main( int argc, const char *argv[] ) {
+  auto config = liblnn::parse_configs( argc, argv );
+  auto [instance,physical_device] = liblnn::get_instance(
+    config,
+    {},{},
+    {},{}
+  );
+  auto props = liblnn::get_device_props( physical_device );
+  auto [device,queue,command_pool] = liblnn::get_device(
+    config, physical_device, {}, {}
+  );
+  std::vector< vk::DescriptorPoolSize > descriptor_pool_size{
+    vk::DescriptorPoolSize().setType( vk::DescriptorType::eStorageBuffer ).setDescriptorCount( 2 )
+  };
+  auto descriptor_pool = liblnn::get_descriptior_pool( device, descriptor_pool_size, 64 );
+  auto pipeline_cache = liblnn::get_pipeline_cache( device );
+  liblnn::modules mods( device );
+  auto allocator = liblnn::get_allocator( physical_device, device );
+  const uint32_t batch_size = 2u;
+  const uint32_t input_channels = 3u;
+  const uint32_t output_channels = 4u;
+  const uint32_t filter_size = 3u;
+  const uint32_t stride = 2u;
+  const std::vector< conv_case > cases{
+    { 7u, 7u, 4u, 4u, 1u, 1u },
+    { 8u, 8u, 4u, 4u, 1u, 1u },
+    { 8u, 8u, 4u, 4u, 0u, 0u },
+    { 9u, 6u, 5u, 3u, 1u, 0u }
+  };
+  std::mt19937 gen( config.seed );
+  std::uniform_real_distribution< float > dist( -1.f, 1.f );
+  bool failed = false;
+  for( const auto layout: { liblnn::tensor_layout::nchw, liblnn::tensor_layout::nhwc } ) {
+    for( const auto &c: cases ) {
+      const bool channels_last = layout == liblnn::tensor_layout::nhwc;
+      auto offset = [&]( int x, int y, int channel, uint32_t width, uint32_t height, uint32_t channels ) {
+        return channels_last ?
+          channel + ( x + y * int( width ) ) * int( channels ) :
+          x + y * int( width ) + channel * int( width * height );
+      };
+      const size_t input_size = c.input_width * c.input_height * input_channels;
+      const size_t output_size = c.output_width * c.output_height * output_channels;
+      const size_t weight_size = filter_size * filter_size * input_channels * output_channels;
+      auto input = create_buffer< float >( allocator, input_size * batch_size );
+      auto output = create_buffer< float >( allocator, output_size * batch_size );
+      auto output_grad = create_buffer< float >( allocator, output_size * batch_size );
+      auto input_grad = create_buffer< float >( allocator, input_size * batch_size );
+      auto weight = create_buffer< glm::vec4 >( allocator, weight_size );
+      auto weight_grad = create_buffer< float >( allocator, weight_size );
+      std::vector< float > input_host( input_size * batch_size );
+      std::vector< float > output_grad_host( output_size * batch_size );
+      std::vector< float > weight_host( weight_size );
+      for( auto &v: input_host ) v = dist( gen );
+      for( auto &v: output_grad_host ) v = dist( gen );
+      for( auto &v: weight_host ) v = dist( gen );
+      {
+        auto mapped = input->map();
+        std::copy( input_host.begin(), input_host.end(), mapped.get() );
+      }
+      {
+        auto mapped = output_grad->map();
+        std::copy( output_grad_host.begin(), output_grad_host.end(), mapped.get() );
+      }
+      {
+        auto mapped = weight->map();
+        for( size_t i = 0u; i != weight_size; ++i )
+          mapped.get()[ i ] = glm::vec4( weight_host[ i ], 0.f, 0.f, 0.f );
+      }
+      std::vector< float > output_expected( output_size * batch_size, 0.f );
+      std::vector< float > input_grad_expected( input_size * batch_size, 0.f );
+      std::vector< float > weight_grad_expected( weight_size, 0.f );
+      for( uint32_t data_index = 0u; data_index != batch_size; ++data_index ) {
+        for( uint32_t oz = 0u; oz != output_channels; ++oz ) {
+          for( uint32_t oy = 0u; oy != c.output_height; ++oy ) {
+            for( uint32_t ox = 0u; ox != c.output_width; ++ox ) {
+              const size_t output_index = offset( ox, oy, oz, c.output_width, c.output_height, output_channels ) + data_index * output_size;
+              for( uint32_t iz = 0u; iz != input_channels; ++iz ) {
+                for( uint32_t fy = 0u; fy != filter_size; ++fy ) {
+                  for( uint32_t fx = 0u; fx != filter_size; ++fx ) {
+                    const int ix = int( ox * stride + fx ) - int( c.xmargin );
+                    const int iy = int( oy * stride + fy ) - int( c.ymargin );
+                    if( ix < 0 || ix >= int( c.input_width ) || iy < 0 || iy >= int( c.input_height ) ) continue;
+                    const size_t input_index = offset( ix, iy, iz, c.input_width, c.input_height, input_channels ) + data_index * input_size;
+                    const size_t filter_index = fx + fy * filter_size + iz * filter_size * filter_size + oz * filter_size * filter_size * input_channels;
+                    output_expected[ output_index ] += input_host[ input_index ] * weight_host[ filter_index ];
+                    input_grad_expected[ input_index ] += output_grad_host[ output_index ] * weight_host[ filter_index ];
+                    weight_grad_expected[ filter_index ] += output_grad_host[ output_index ] * input_host[ input_index ];
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+      std::vector< std::shared_ptr< liblnn::layer > > layers;
+      layers.emplace_back( new liblnn::layer( liblnn::create_conv_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input, output, weight, liblnn::buffer_view< glm::vec4 >(),
+        c.output_width, c.output_height, output_channels, batch_size, filter_size, filter_size, input_channels, stride, stride, 1, c.xmargin, c.ymargin,
+        false, 0.01f, c.input_width, c.input_height, layout
+      ) ) );
+      layers.emplace_back( new liblnn::layer( liblnn::create_conv2_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input, output, weight, input_grad, output_grad,
+        c.output_width, c.output_height, output_channels, batch_size, filter_size, filter_size, input_channels, stride, stride, 1, c.xmargin, c.ymargin,
+        c.input_width, c.input_height, layout
+      ) ) );
+      layers.emplace_back( new liblnn::layer( liblnn::create_conv_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input, output, weight, weight_grad, output_grad,
+        c.output_width, c.output_height, output_channels, batch_size, filter_size, filter_size, input_channels, stride, stride, 1, c.xmargin, c.ymargin,
+        c.input_width, c.input_height, layout
+      ) ) );
+      auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
+      auto &command_buffer = (*command_buffers)[ 0 ];
+      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+      for( const auto &layer: layers )
+        (*layer)( command_buffer );
+      command_buffer.end();
+      queue->submit(
+        vk::SubmitInfo()
+          .setCommandBufferCount( 1 )
+          .setPCommandBuffers( &command_buffer ),
+        vk::Fence()
+      );
+      queue->waitIdle();
+      const float output_error = max_error( output_expected, output->map() );
+      const float input_grad_error = max_error( input_grad_expected, input_grad->map() );
+      const float weight_grad_error = max_error( weight_grad_expected, weight_grad->map() );
+      const bool ok = output_error < 1.0e-4f && input_grad_error < 1.0e-4f && weight_grad_error < 1.0e-4f;
+      std::cout << ( channels_last ? "nhwc " : "nchw " ) <<
+        c.input_width << "x" << c.input_height << " -> " << c.output_width << "x" << c.output_height <<
+        " margin " << c.xmargin << "," << c.ymargin <<
+        " forward: " << output_error << " input_grad: " << input_grad_error << " weight_grad: " << weight_grad_error <<
+        ( ok ? " ok" : " NG" ) << std::endl;
+      if( !ok ) failed = true;
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -32,6 +32,7 @@ namespace liblnn {
     po::options_description desc( "Options" );
     unsigned int device_index = 0u;
     std::string dump_file;
+    std::string tuning_file;
     std::string train_data;
     std::string train_label;
     std::string eval_data;
@@ -40,12 +41,18 @@ namespace liblnn {
     unsigned int hidden_width = 0u;
     unsigned int c1_channels = 0u;
     unsigned int c2_channels = 0u;
+    float clip_norm = 0.f;
+    unsigned int seed = 0u;
+    float dropout = 0.f;
+    unsigned int residual_blocks = 0u;
+    float leaky_slope = 0.f;
     desc.add_options()
       ( "help,h", "show this message" )
       ( "list,l", "show all available devices" )
       ( "device,d", po::value< unsigned int >(&device_index)->default_value( 0u ), "use specific device" )
       ( "validation,v", "use VK_LAYER_LUNARG_standard_validation" )
       ( "dump_file,o", po::value< std::string >(&dump_file)->default_value( "nn.dump" ), "dump file" )
+      ( "tuning_file", po::value< std::string >(&tuning_file)->default_value( "" ), "per-device workgroup size database written by tune_conv10_network" )
       ( "train_data", po::value< std::string >(&train_data)->default_value( "../../mnist/train-images-idx3-ubyte" ), "train data" )
       ( "train_label", po::value< std::string >(&train_label)->default_value( "../../mnist/train-labels-idx1-ubyte" ), "train label" )
       ( "eval_data", po::value< std::string >(&eval_data)->default_value( "../../mnist/t10k-images-idx3-ubyte" ), "eval data" )
@@ -54,6 +61,23 @@ namespace liblnn {
       ( "hidden_width,e", po::value< unsigned int >(&hidden_width)->default_value( 128u ), "hidden width" )
       ( "c1_channels,i", po::value< unsigned int >(&c1_channels)->default_value( 16u ), "c1 channels" )
       ( "c2_channels,j", po::value< unsigned int >(&c2_channels)->default_value( 32u ), "c2 channels" )
+      ( "clip_norm", po::value< float >(&clip_norm)->default_value( 0.f ), "clip gradients to this global norm ( 0 to disable )" )
+      ( "seed,s", po::value< unsigned int >(&seed)->default_value( 0u ), "seed for weight initialization" )
+      ( "dropout", po::value< float >(&dropout)->default_value( 0.f ), "drop rate of the hidden layer ( 0 to disable )" )
+      ( "residual_blocks", po::value< unsigned int >(&residual_blocks)->default_value( 0u ), "residual blocks appended to the second convolution stage" )
+      ( "leaky_slope", po::value< float >(&leaky_slope)->default_value( 0.f ), "negative slope of the first convolution stage activations ( 0 for relu )" )
+      ( "separable", "use a depthwise-separable convolution at the entry of the second stage ( ignored with --batchnorm or --strided )" )
+      ( "strided", "downsample the first stage with a stride-2 convolution instead of max pooling" )
+      ( "global_pool", "feed the classifier head with global average pooled channels instead of the max pooled feature map" )
+      ( "bias", "add trainable biases to the hidden and output affine layers" )
+      ( "nhwc", "store images and convolution activations channels last" )
+      ( "relu_mask", "keep 1bit relu masks for the backward pass instead of the pre-activation values of the convolution network" )
+      ( "in_place", "run activations in place on the buffers of their producers where the backward pass allows it ( leaky relu or --relu_mask )" )
+      ( "checkpoint", "reuse the first stage activations for the second stage and recompute them before the first stage backward ( not available for quantization )" )
+      ( "bf16", "store activations and deferred weight gradients as packed bfloat16 ( requires --clip_norm )" )
+      ( "fused_block", "evaluate the first conv10 block with a single kernel that keeps its intermediates in shared memory ( ignored with --batchnorm, --strided or quantization )" )
+      ( "batchnorm", "insert batch normalization after the first convolution of each block" )
+      ( "megakernel", "run each training step of the simple network as a single dispatch" )
       ( "debug,g", "debug mode" );
     po::variables_map vm;
     po::store( po::parse_command_line( argc, argv, desc ), vm );
@@ -62,12 +86,15 @@ namespace liblnn {
       std::cout << desc << std::endl;
       exit( 0 );
     }
+    if( vm.count( "bf16" ) && clip_norm <= 0.f )
+      throw po::error( "--bf16 requires --clip_norm" );
     return configs_t()
       .set_prog_name( std::filesystem::path( argv[ 0 ] ).filename().native() )
       .set_device_index( device_index )
       .set_list( vm.count( "list" ) )
       .set_validation( vm.count( "validation" ) )
       .set_dump_file( dump_file )
+      .set_tuning_file( tuning_file )
       .set_train_data( train_data )
       .set_train_label( train_label )
       .set_eval_data( eval_data )
@@ -76,6 +103,23 @@ namespace liblnn {
       .set_hidden_width( hidden_width )
       .set_c1_channels( c1_channels )
       .set_c2_channels( c2_channels )
+      .set_clip_norm( clip_norm )
+      .set_seed( seed )
+      .set_dropout( dropout )
+      .set_residual_blocks( residual_blocks )
+      .set_leaky_slope( leaky_slope )
+      .set_separable( vm.count( "separable" ) )
+      .set_strided( vm.count( "strided" ) )
+      .set_global_pool( vm.count( "global_pool" ) )
+      .set_bias( vm.count( "bias" ) )
+      .set_nhwc( vm.count( "nhwc" ) )
+      .set_relu_mask( vm.count( "relu_mask" ) )
+      .set_in_place( vm.count( "in_place" ) )
+      .set_checkpoint( vm.count( "checkpoint" ) )
+      .set_bf16( vm.count( "bf16" ) )
+      .set_fused_block( vm.count( "fused_block" ) )
+      .set_batchnorm( vm.count( "batchnorm" ) )
+      .set_megakernel( vm.count( "megakernel" ) )
       .set_debug_mode( vm.count( "debug" ) );
   }
 }
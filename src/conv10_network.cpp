@@ -51,69 +51,95 @@ namespace liblnn {
     const std::shared_ptr< data_source > &tin_,
     const std::shared_ptr< data_source > &ein_,
     const liblnn::modules &mods,
-    size_t c1_channels_,
-    size_t c2_channels_,
-    size_t hidden_width_,
-    size_t batch_size_,
-    bool debug_
-  ) : network( command_pool_, device_, queue_, descriptor_pool_, pipeline_cache_, props_, allocator_, tin_, ein_, mods, batch_size_, debug_ ), image_width( tin_->get_image_width() ), image_height( tin_->get_image_height() ), image_channels( tin_->get_image_channel() ), c1_width( tin_->get_image_width() / 2 ), c1_height( tin_->get_image_height() / 2 ), c1_channels( c1_channels_ ), c2_width( tin_->get_image_width() / 4 ), c2_height( tin_->get_image_height() / 4 ), c2_channels( c2_channels_ ), hidden_width( hidden_width_ ), output_width( tin_->get_label_width() ) {
+    const configs_t &config
+  ) : network( command_pool_, device_, queue_, descriptor_pool_, pipeline_cache_, props_, allocator_, tin_, ein_, mods, config.batch_size, config.debug_mode ), image_width( tin_->get_image_width() ), image_height( tin_->get_image_height() ), image_channels( tin_->get_image_channel() ), c1_width( tin_->get_image_width() / 2 ), c1_height( tin_->get_image_height() / 2 ), c1_channels( config.c1_channels ), c2_width( tin_->get_image_width() / 4 ), c2_height( tin_->get_image_height() / 4 ), c2_channels( config.c2_channels ), hidden_width( config.hidden_width ), output_width( tin_->get_label_width() ), batchnorm( config.batchnorm ), dropout( config.dropout ), leaky_slope( config.leaky_slope ) {
+    max_grad_norm = config.clip_norm;
     auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    const size_t head_width = config.global_pool ? c2_channels : c2_width * c2_height * c2_channels;
+    const tensor_layout layout = config.nhwc ? tensor_layout::nhwc : tensor_layout::nchw;
+    if( image_channels != 1 && ( tin_->get_layout() != layout || ein_->get_layout() != layout ) ) throw unsupported_layout();
+    const bool c1_relu_mask = config.relu_mask && leaky_slope <= 0.f;
+    const bool c1_in_place = config.in_place && ( leaky_slope > 0.f || config.relu_mask );
+    const bool c2_in_place = config.in_place && config.relu_mask;
+    if( config.checkpoint && config.quantize ) throw unsupported_checkpoint();
+    const bool checkpoint = config.checkpoint;
+    const bool c2_pool_fused = !config.global_pool && config.residual_blocks == 0u;
+    const bool c1_fused = leaky_slope > 0.f && !batchnorm;
+    const bool bf16_activations = config.bf16 && !config.quantize;
     c1_conv1_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * image_channels * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv1_weight, image_width * image_height * image_channels );
+    weights.emplace_back( c1_conv1_weight, 3 * 3 * image_channels, init_type::he );
     c1_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv2_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv2_weight, 3 * 3, init_type::he );
     c1_conv3_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv3_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv3_weight, 3 * 3, init_type::he );
     c2_conv1_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * c2_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c2_conv1_weight, c1_width * c1_height * c1_channels );
+    weights.emplace_back( c2_conv1_weight, 3 * 3 * c1_channels, init_type::he );
     c2_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c2_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c2_conv2_weight, c1_width * c1_height * c2_channels );
+    weights.emplace_back( c2_conv2_weight, 3 * 3, init_type::he );
     c2_conv3_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c2_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c2_conv3_weight, c1_width * c1_height * c2_channels );
+    weights.emplace_back( c2_conv3_weight, 3 * 3, init_type::he );
     hidden_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c2_width * c2_height * c2_channels * hidden_width * sizeof( glm::vec4 ) )
+        .setSize( head_width * hidden_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( hidden_weight, c2_width * c2_height * c2_channels );
+    weights.emplace_back( hidden_weight, head_width, init_type::he );
     output_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * output_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( output_weight, hidden_width );
+    weights.emplace_back( output_weight, hidden_width, init_type::he );
+    if( config.bias ) {
+      hidden_bias.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( hidden_width * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( hidden_bias, head_width, init_type::zero );
+      output_bias.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( output_width * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( output_bias, hidden_width, init_type::zero );
+    }
+    const auto hidden_bias_view = hidden_bias ? buffer_view< glm::vec4 >( hidden_bias ) : buffer_view< glm::vec4 >();
+    const auto output_bias_view = output_bias ? buffer_view< glm::vec4 >( output_bias ) : buffer_view< glm::vec4 >();
     c1_conv1_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -124,7 +150,7 @@ namespace liblnn {
     c1_activation1_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c1_conv1_output->size() * sizeof( float ) )
+        .setSize( ( bf16_activations && !c1_fused ? ( c1_conv1_output->size() + 1 ) / 2 : c1_conv1_output->size() ) * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
     buffers.insert( std::make_pair( std::string( "c1_activation1_output" ), c1_activation1_output ) );
@@ -135,26 +161,32 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
     buffers.insert( std::make_pair( std::string( "c1_conv2_output" ), c1_conv2_output ) );
-    c1_activation2_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_conv2_output->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
+    if( c1_in_place ) c1_activation2_output = c1_conv2_output;
+    else
+      c1_activation2_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( ( bf16_activations ? ( c1_conv2_output->size() + 1 ) / 2 : c1_conv2_output->size() ) * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+        ) );
     buffers.insert( std::make_pair( std::string( "c1_activation2_output" ), c1_activation2_output ) );
-    c1_conv3_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
+    if( c1_relu_mask && !c1_in_place ) c1_conv3_output = c1_conv2_output;
+    else
+      c1_conv3_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+        ) );
     buffers.insert( std::make_pair( std::string( "c1_conv3_output" ), c1_conv3_output ) );
-    c1_activation3_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_conv3_output->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
+    if( c1_in_place ) c1_activation3_output = c1_conv3_output;
+    else
+      c1_activation3_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( ( bf16_activations ? ( c1_conv3_output->size() + 1 ) / 2 : c1_conv3_output->size() ) * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+        ) );
     buffers.insert( std::make_pair( std::string( "c1_activation3_output" ), c1_activation3_output ) );
     c1_mp_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -163,52 +195,42 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
     buffers.insert( std::make_pair( std::string( "c1_mp_output" ), c1_mp_output ) );
-    c2_conv1_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_width * c1_height * c2_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
-    buffers.insert( std::make_pair( std::string( "c2_conv1_output" ), c2_conv1_output ) );
-    c2_activation1_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_conv1_output->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
-    buffers.insert( std::make_pair( std::string( "c2_activation1_output" ), c2_activation1_output ) );
-    c2_conv2_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_width * c1_height * c2_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
-    buffers.insert( std::make_pair( std::string( "c2_conv2_output" ), c2_conv2_output ) );
-    c2_activation2_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_conv2_output->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
-    buffers.insert( std::make_pair( std::string( "c2_activation2_output" ), c2_activation2_output ) );
-    c2_conv3_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_width * c1_height * c2_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-      ) );
-    buffers.insert( std::make_pair( std::string( "c2_conv3_output" ), c2_conv3_output ) );
-    c2_activation3_output.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_conv3_output->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+    std::vector< std::shared_ptr< liblnn::buffer< float > > > recompute_slots;
+    if( checkpoint )
+      for( const auto &buf: { c1_conv1_output, c1_activation1_output, c1_conv2_output, c1_activation2_output, c1_conv3_output, c1_activation3_output } )
+        if( std::find( recompute_slots.begin(), recompute_slots.end(), buf ) == recompute_slots.end() && !( config.strided && buf == c1_activation3_output ) )
+          recompute_slots.push_back( buf );
+    auto c2_buffer = [&]( const std::string &name, bool packed = false ) -> buffer_view< float > {
+      const size_t unpacked_size = c1_width * c1_height * c2_channels * batch_size;
+      const size_t size = packed ? ( unpacked_size + 1 ) / 2 : unpacked_size;
+      if( !recompute_slots.empty() && recompute_slots.front()->size() >= size ) {
+        const auto slot = recompute_slots.front();
+        recompute_slots.erase( recompute_slots.begin() );
+        return buffer_view< float >( slot, 0, size );
+      }
+      std::shared_ptr< liblnn::buffer< float > > buf( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
-    buffers.insert( std::make_pair( std::string( "c2_activation3_output" ), c2_activation3_output ) );
+      buffers.insert( std::make_pair( name, buf ) );
+      return buf;
+    };
+    c2_conv1_output = c2_buffer( "c2_conv1_output" );
+    if( c2_in_place && !batchnorm ) c2_activation1_output = c2_conv1_output;
+    else c2_activation1_output = c2_buffer( "c2_activation1_output", bf16_activations );
+    c2_conv2_output = c2_buffer( "c2_conv2_output" );
+    if( c2_in_place ) c2_activation2_output = c2_conv2_output;
+    else c2_activation2_output = c2_buffer( "c2_activation2_output", bf16_activations );
+    if( config.relu_mask && !c2_in_place ) c2_conv3_output = c2_conv2_output;
+    else c2_conv3_output = c2_buffer( "c2_conv3_output" );
+    if( c2_in_place ) c2_activation3_output = c2_conv3_output;
+    else c2_activation3_output = c2_buffer( "c2_activation3_output", bf16_activations && c2_pool_fused );
     c2_mp_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c2_width * c2_height * c2_channels * batch_size * sizeof( float ) )
+        .setSize( head_width * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
     buffers.insert( std::make_pair( std::string( "c2_mp_output" ), c2_mp_output ) );
@@ -219,13 +241,22 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
       ) );
     buffers.insert( std::make_pair( std::string( "hidden_affine_output" ), hidden_affine_output ) );
-    hidden_activation_output.reset( new liblnn::buffer< float >(
+    if( c2_in_place ) hidden_activation_output = hidden_affine_output;
+    else
+      hidden_activation_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( hidden_width * batch_size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+    buffers.insert( std::make_pair( std::string( "hidden_activation_output" ), hidden_activation_output ) );
+    hidden_dropout_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
-    buffers.insert( std::make_pair( std::string( "hidden_activation_output" ), hidden_activation_output ) );
+    buffers.insert( std::make_pair( std::string( "hidden_dropout_output" ), hidden_dropout_output ) );
     output_affine_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -267,17 +298,26 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "output_affine_grad" ), output_affine_grad ) );
-    hidden_activation_grad.reset( new liblnn::buffer< float >(
+    hidden_dropout_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
+    buffers.insert( std::make_pair( std::string( "hidden_dropout_grad" ), hidden_dropout_grad ) );
+    if( c2_in_place ) hidden_activation_grad = dropout > 0.f ? hidden_dropout_grad : output_affine_grad;
+    else
+      hidden_activation_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( hidden_width * batch_size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "hidden_activation_grad" ), hidden_activation_grad ) );
     hidden_affine_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c2_width * c2_height * c2_channels * batch_size * sizeof( float ) )
+        .setSize( head_width * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "hidden_affine_grad" ), hidden_affine_grad ) );
@@ -288,12 +328,14 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
     ) );
     buffers.insert( std::make_pair( std::string( "c2_mp_grad" ), c2_mp_grad ) );
-    c2_activation3_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_mp_grad->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-    ) );
+    if( c2_in_place || c2_pool_fused ) c2_activation3_grad = c2_mp_grad;
+    else
+      c2_activation3_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_mp_grad->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "c2_activation3_grad" ), c2_activation3_grad ) );
     c2_conv3_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -302,12 +344,14 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c2_conv3_grad" ), c2_conv3_grad ) );
-    c2_activation2_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_conv3_grad->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-    ) );
+    if( c2_in_place ) c2_activation2_grad = c2_conv3_grad;
+    else
+      c2_activation2_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_conv3_grad->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "c2_activation2_grad" ), c2_activation2_grad ) );
     c2_conv2_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -316,12 +360,14 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c2_conv2_grad" ), c2_conv2_grad ) );
-    c2_activation1_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c2_conv2_grad->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-    ) );
+    if( c2_in_place && !batchnorm ) c2_activation1_grad = c2_conv2_grad;
+    else
+      c2_activation1_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_conv2_grad->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "c2_activation1_grad" ), c2_activation1_grad ) );
     c2_conv1_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -339,12 +385,14 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
     ) );
     buffers.insert( std::make_pair( std::string( "c1_mp_grad" ), c1_mp_grad ) );
-    c1_activation3_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_mp_grad->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-    ) );
+    if( c1_in_place || !config.strided ) c1_activation3_grad = c1_mp_grad;
+    else
+      c1_activation3_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_mp_grad->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "c1_activation3_grad" ), c1_activation3_grad ) );
     c1_conv3_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -353,12 +401,14 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c1_conv3_grad" ), c1_conv3_grad ) );
-    c1_activation2_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_conv3_grad->size() * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
-    ) );
+    if( c1_in_place ) c1_activation2_grad = c1_conv3_grad;
+    else
+      c1_activation2_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_conv3_grad->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
     buffers.insert( std::make_pair( std::string( "c1_activation2_grad" ), c1_activation2_grad ) );
     c1_conv2_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
@@ -381,6 +431,74 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c1_conv1_grad" ), c1_conv1_grad ) );
+    if( batchnorm ) {
+      c1_bn1_weight.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( 3 * c1_channels * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( c1_bn1_weight, c1_channels, init_type::batchnorm );
+      c1_conv1_folded_weight.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_conv1_weight->size() * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      c1_conv1_bias.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_channels * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      c1_bn1_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_conv1_output->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( std::string( "c1_bn1_output" ), c1_bn1_output ) );
+      c1_bn1_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c1_conv1_output->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( std::string( "c1_bn1_grad" ), c1_bn1_grad ) );
+      c2_bn1_weight.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( 3 * c2_channels * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( c2_bn1_weight, c2_channels, init_type::batchnorm );
+      c2_conv1_folded_weight.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_conv1_weight->size() * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      c2_conv1_bias.reset( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_channels * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      c2_bn1_output.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_conv1_output.size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( std::string( "c2_bn1_output" ), c2_bn1_output ) );
+      c2_bn1_grad.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( c2_conv1_output.size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( std::string( "c2_bn1_grad" ), c2_bn1_grad ) );
+    }
     error_out.reset( new liblnn::buffer< float >(
       allocator, VMA_MEMORY_USAGE_GPU_TO_CPU,
       vk::BufferCreateInfo()
@@ -391,78 +509,173 @@ namespace liblnn {
 
     c1_conv1_1.reset( new layer( create_conv_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      batch_images[ 0 ], c1_conv1_output, c1_conv1_weight,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      batch_images[ 0 ], c1_fused ? c1_activation1_output : c1_conv1_output, c1_conv1_weight, buffer_view< glm::vec4 >(),
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, c1_fused, leaky_slope, 0u, 0u, layout
     ) ) );
     c1_conv1_2.reset( new layer( create_conv_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      batch_images[ 1 ], c1_conv1_output, c1_conv1_weight,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      batch_images[ 1 ], c1_fused ? c1_activation1_output : c1_conv1_output, c1_conv1_weight, buffer_view< glm::vec4 >(),
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, c1_fused, leaky_slope, 0u, 0u, layout
     ) ) );
     c1_conv1_3.reset( new layer( create_conv_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      batch_images[ 2 ], c1_conv1_output, c1_conv1_weight,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_activation1.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c1_conv1_output, c1_activation1_output
+      batch_images[ 2 ], c1_fused ? c1_activation1_output : c1_conv1_output, c1_conv1_weight, buffer_view< glm::vec4 >(),
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, c1_fused, leaky_slope, 0u, 0u, layout
     ) ) );
+    if( !c1_fused )
+      c1_activation1.reset( new layer( leaky_slope > 0.f ?
+        create_leaky_relu_forward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props, batchnorm ? c1_bn1_output : c1_conv1_output, c1_activation1_output, leaky_slope
+        ) :
+        create_relu_forward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props, batchnorm ? c1_bn1_output : c1_conv1_output, c1_activation1_output
+        )
+      ) );
+    const auto c1_activation2_mask = c1_relu_mask ? relu_mask( c1_conv2_output->size() ) : buffer_view< float >();
+    const auto c1_activation3_mask = c1_relu_mask ? relu_mask( c1_conv3_output->size() ) : buffer_view< float >();
     c1_conv2.reset( new layer( create_conv_straight_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c1_activation1_output, c1_conv2_output, c1_conv2_weight,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_activation2.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c1_conv2_output, c1_activation2_output
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c1_activation2.reset( new layer( leaky_slope > 0.f ?
+      create_leaky_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv2_output, c1_activation2_output, leaky_slope
+      ) :
+      c1_relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv2_output, c1_activation2_output, c1_activation2_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv2_output, c1_activation2_output
+      )
+    ) );
     c1_conv3.reset( new layer( create_conv_straight_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation1_output, c1_conv3_output, c1_conv3_weight,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_activation3.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c1_conv3_output, c1_activation3_output
-    ) ) );
-    c1_mp.reset( new layer( create_max_pooling_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c1_activation3_output, c1_mp_output,
-      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2
-    ) ) );
-    c2_conv1.reset( new layer( create_conv_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_mp_output, c2_conv1_output, c2_conv1_weight,
-      c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_activation1.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c2_conv1_output, c2_activation1_output
+      c1_activation2_output, c1_conv3_output, c1_conv3_weight,
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c1_activation3.reset( new layer( leaky_slope > 0.f ?
+      create_leaky_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv3_output, c1_activation3_output, leaky_slope
+      ) :
+      c1_relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv3_output, c1_activation3_output, c1_activation3_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_conv3_output, c1_activation3_output
+      )
+    ) );
+    if( !config.strided )
+      c1_mp.reset( new layer( create_max_pooling_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c1_activation3_output, c1_mp_output,
+        c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2, layout
+      ) ) );
+    if( config.fused_block && !batchnorm && !config.strided && !config.quantize && c1_width * 2 == image_width && c1_height * 2 == image_height )
+      c1_block.reset( new layer( create_conv_block_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, batch_images[ 2 ], c1_mp_output, c1_conv1_weight, c1_conv2_weight, c1_conv3_weight,
+        c1_width, c1_height, image_channels, c1_channels, batch_size, leaky_slope > 0.f ? leaky_slope : 0.f, layout
+      ) ) );
+    const auto c2_input = config.strided ? c1_activation3_output : c1_mp_output;
+    const auto c2_input_grad = config.strided ? c1_mp_grad : c2_conv1_grad;
+    const uint32_t c2_input_width = config.strided ? image_width : c1_width;
+    const uint32_t c2_input_height = config.strided ? image_height : c1_height;
+    const uint32_t c2_stride = config.strided ? 2 : 1;
+    if( config.separable && !batchnorm && !config.strided )
+      c2_separable = build_separable_conv(
+        "c2_separable", c1_mp_output, c2_conv1_grad, c2_conv1_output, c2_activation1_grad,
+        c1_width, c1_height, c1_channels, c2_channels, layout
+      );
+    else
+      c2_conv1.reset( new layer( create_conv_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_input, c2_conv1_output, c2_conv1_weight, buffer_view< glm::vec4 >(),
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, c2_stride, c2_stride, 1, 1, 1,
+        false, leaky_slope, c2_input_width, c2_input_height, layout
+      ) ) );
+    const auto c2_activation1_mask = config.relu_mask ? relu_mask( c2_conv1_output.size() ) : buffer_view< float >();
+    const auto c2_activation2_mask = config.relu_mask ? relu_mask( c2_conv2_output.size() ) : buffer_view< float >();
+    const auto c2_activation3_mask = config.relu_mask ? relu_mask( c2_conv3_output.size() ) : buffer_view< float >();
+    c2_activation1.reset( new layer( config.relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, batchnorm ? c2_bn1_output : c2_conv1_output, c2_activation1_output, c2_activation1_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, batchnorm ? c2_bn1_output : c2_conv1_output, c2_activation1_output
+      )
+    ) );
     c2_conv2.reset( new layer( create_conv_straight_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c2_activation1_output, c2_conv2_output, c2_conv2_weight,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_activation2.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c2_conv2_output, c2_activation2_output
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c2_activation2.reset( new layer( config.relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_conv2_output, c2_activation2_output, c2_activation2_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_conv2_output, c2_activation2_output
+      )
+    ) );
     c2_conv3.reset( new layer( create_conv_straight_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c2_activation2_output, c2_conv3_output, c2_conv3_weight,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_activation3.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c2_conv3_output, c2_activation3_output
-    ) ) );
-    c2_mp.reset( new layer( create_max_pooling_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c2_activation3_output, c2_mp_output,
-      c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c2_activation3.reset( new layer( config.relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_conv3_output, c2_activation3_output, c2_activation3_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_conv3_output, c2_activation3_output
+      )
+    ) );
+    buffer_view< float > c2_output = c2_activation3_output;
+    buffer_view< float > c2_output_grad = c2_mp_grad;
+    for( size_t index = 0u; index != config.residual_blocks; ++index ) {
+      c2_residual.emplace_back( build_residual_block(
+        "c2_residual" + std::to_string( index ), c2_output, c2_output_grad,
+        c1_width, c1_height, c2_channels, 0.0001f, layout, bf16_activations
+      ) );
+      c2_output = c2_residual.back().output;
+      c2_output_grad = c2_residual.back().output_grad;
+    }
+    c2_mp.reset( new layer( config.global_pool ?
+      create_global_average_pooling_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_output, c2_mp_output,
+        c1_width, c1_height, c2_channels, batch_size, layout
+      ) :
+      create_max_pooling_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, c2_output, c2_mp_output,
+        c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2, layout
+      )
+    ) );
     hidden_affine.reset( new layer( create_affine_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, c2_mp_output, hidden_affine_output, hidden_weight, batch_size
-    ) ) );
-    hidden_activation.reset( new layer( create_relu_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, hidden_affine_output, hidden_activation_output
+      device, mods, descriptor_pool, pipeline_cache, props, c2_mp_output, hidden_affine_output, hidden_weight, hidden_bias_view, batch_size
     ) ) );
+    const auto hidden_activation_mask = config.relu_mask ? relu_mask( hidden_width * batch_size ) : buffer_view< float >();
+    hidden_activation.reset( new layer( config.relu_mask ?
+      create_relu_mask_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_affine_output, hidden_activation_output, hidden_activation_mask
+      ) :
+      create_relu_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_affine_output, hidden_activation_output
+      )
+    ) );
+    const auto hidden_output = dropout > 0.f ? hidden_dropout_output : hidden_activation_output;
+    const auto hidden_output_grad = dropout > 0.f ? hidden_dropout_grad : output_affine_grad;
+    const auto hidden_dropout_mask = dropout > 0.f ? dropout_mask( hidden_width * batch_size ) : buffer_view< float >();
+    if( dropout > 0.f ) {
+      hidden_dropout.reset( new layer( create_dropout_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_activation_output, hidden_dropout_output, hidden_dropout_mask, dropout, config.seed
+      ) ) );
+      output_affine_eval.reset( new layer( create_affine_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_activation_output, output_affine_output, output_weight, output_bias_view, batch_size
+      ) ) );
+    }
     output_affine.reset( new layer( create_affine_forward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, hidden_activation_output, output_affine_output, output_weight, batch_size
+      device, mods, descriptor_pool, pipeline_cache, props, hidden_output, output_affine_output, output_weight, output_bias_view, batch_size
     ) ) );
     output_activation.reset( new layer( create_tanh_forward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props, output_affine_output, output_activation_output
@@ -479,244 +692,540 @@ namespace liblnn {
     output_activation_backward.reset( new layer( create_tanh_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props, output_affine_output, output_activation_output, output_activation_grad, softmax_grad
     ) ) );
+    const auto c1_conv1_weight_grad = deferred_grad( c1_conv1_weight, 0.0001f, config.bf16 );
+    const auto c1_conv2_weight_grad = deferred_grad( c1_conv2_weight, 0.001f, config.bf16 );
+    const auto c1_conv3_weight_grad = deferred_grad( c1_conv3_weight, 0.001f, config.bf16 );
+    const auto c2_conv1_weight_grad = c2_conv1 ? deferred_grad( c2_conv1_weight, 0.0001f, config.bf16 ) : buffer_view< float >();
+    const auto c2_conv2_weight_grad = deferred_grad( c2_conv2_weight, 0.001f, config.bf16 );
+    const auto c2_conv3_weight_grad = deferred_grad( c2_conv3_weight, 0.001f, config.bf16 );
+    const auto hidden_weight_grad = deferred_grad( hidden_weight, 0.001f, config.bf16 );
+    const auto output_weight_grad = deferred_grad( output_weight, 0.001f, config.bf16 );
+    const auto hidden_bias_grad = hidden_bias ? deferred_grad( hidden_bias, 0.001f ) : buffer_view< float >();
+    const auto output_bias_grad = output_bias ? deferred_grad( output_bias, 0.001f ) : buffer_view< float >();
     output_affine_backward.reset( new layer( create_affine_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, hidden_activation_output, output_affine_output, output_weight, output_affine_grad, output_activation_grad, batch_size
-    ) ) );
-    hidden_activation_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props, hidden_affine_output, hidden_activation_output, hidden_activation_grad, output_affine_grad
+      device, mods, descriptor_pool, pipeline_cache, props, hidden_output, output_affine_output, output_weight, output_weight_grad, output_bias_view, output_bias_grad, output_affine_grad, output_activation_grad, batch_size
     ) ) );
+    if( dropout > 0.f )
+      hidden_dropout_backward.reset( new layer( create_dropout_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_dropout_mask, hidden_dropout_grad, output_affine_grad, dropout
+      ) ) );
+    hidden_activation_backward.reset( new layer( config.relu_mask ?
+      create_relu_mask_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_activation_mask, hidden_activation_grad, hidden_output_grad
+      ) :
+      create_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, hidden_affine_output, hidden_activation_output, hidden_activation_grad, hidden_output_grad
+      )
+    ) );
     hidden_affine_backward.reset( new layer( create_affine_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c2_mp_output, hidden_affine_output, hidden_weight,
+      c2_mp_output, hidden_affine_output, hidden_weight, hidden_weight_grad, hidden_bias_view, hidden_bias_grad,
       hidden_affine_grad, hidden_activation_grad,
       batch_size
     ) ) );
-    c2_mp_backward.reset( new layer( create_max_pooling_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c2_activation3_output, c2_mp_output, c2_mp_grad, hidden_affine_grad,
-      c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2
-    ) ) );
-    c2_activation3_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c2_conv3_output, c2_activation3_output,
-      c2_activation3_grad, c2_mp_grad
-    ) ) );
+    c2_mp_backward.reset( new layer( config.global_pool ?
+      create_global_average_pooling_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_output_grad, hidden_affine_grad,
+        c1_width, c1_height, c2_channels, batch_size, layout
+      ) :
+      c2_pool_fused ?
+      create_max_pooling_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        config.relu_mask ? c2_activation3_output : c2_conv3_output, c2_mp_output, c2_activation3_mask, c2_activation3_grad, hidden_affine_grad,
+        c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2, 0.f, layout
+      ) :
+      create_max_pooling_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_output, c2_mp_output, c2_output_grad, hidden_affine_grad,
+        c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2, layout
+      )
+    ) );
+    if( !c2_pool_fused )
+      c2_activation3_backward.reset( new layer( config.relu_mask ?
+        create_relu_mask_backward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c2_activation3_mask, c2_activation3_grad, c2_mp_grad
+        ) :
+        create_relu_backward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c2_conv3_output, c2_activation3_output,
+          c2_activation3_grad, c2_mp_grad
+        )
+      ) );
     c2_conv3_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c2_activation2_output, c2_conv3_output, c2_conv3_weight, c2_conv3_grad, c2_activation3_grad,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
     c2_conv3_update_backward.reset( new layer( create_conv_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c2_activation2_output, c2_conv3_output, c2_conv3_weight, c2_activation3_grad,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_activation2_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c2_conv2_output, c2_activation2_output,
-      c2_activation2_grad, c2_conv3_grad
+      c2_activation2_output, c2_conv3_output, c2_conv3_weight, c2_conv3_weight_grad, c2_activation3_grad,
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c2_activation2_backward.reset( new layer( config.relu_mask ?
+      create_relu_mask_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_activation2_mask, c2_activation2_grad, c2_conv3_grad
+      ) :
+      create_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_conv2_output, c2_activation2_output,
+        c2_activation2_grad, c2_conv3_grad
+      )
+    ) );
     c2_conv2_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c2_activation1_output, c2_conv2_output, c2_conv2_weight, c2_conv2_grad, c2_activation2_grad,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
     c2_conv2_update_backward.reset( new layer( create_conv_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c2_activation1_output, c2_conv2_output, c2_conv2_weight, c2_activation2_grad,
-      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_activation1_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c2_conv1_output, c2_activation1_output,
-      c2_activation1_grad, c2_conv2_grad
-    ) ) );
-    c2_conv1_bp_backward.reset( new layer( create_conv2_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_mp_output, c2_conv1_output, c2_conv1_weight, c2_conv1_grad, c2_activation1_grad,
-      c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c2_conv1_update_backward.reset( new layer( create_conv_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_mp_output, c2_conv1_output, c2_conv1_weight, c2_activation1_grad,
-      c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_mp_backward.reset( new layer( create_max_pooling_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation2_output, c1_mp_output, c1_mp_grad, c2_conv1_grad,
-      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2
-    ) ) );
-    c1_activation3_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_conv3_output, c1_activation3_output,
-      c1_activation3_grad, c1_mp_grad
+      c2_activation1_output, c2_conv2_output, c2_conv2_weight, c2_conv2_weight_grad, c2_activation2_grad,
+      c1_width, c1_height, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c2_activation1_backward.reset( new layer( config.relu_mask ?
+      create_relu_mask_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_activation1_mask, batchnorm ? c2_bn1_grad : c2_activation1_grad, c2_conv2_grad
+      ) :
+      create_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        batchnorm ? c2_bn1_output : c2_conv1_output, c2_activation1_output,
+        batchnorm ? c2_bn1_grad : c2_activation1_grad, c2_conv2_grad
+      )
+    ) );
+    if( c2_conv1 ) {
+      c2_conv1_bp_backward.reset( new layer( create_conv2_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_input, c2_conv1_output, c2_conv1_weight, c2_input_grad, c2_activation1_grad,
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, c2_stride, c2_stride, 1, 1, 1,
+        c2_input_width, c2_input_height, layout
+      ) ) );
+      c2_conv1_update_backward.reset( new layer( create_conv_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_input, c2_conv1_output, c2_conv1_weight, c2_conv1_weight_grad, c2_activation1_grad,
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, c2_stride, c2_stride, 1, 1, 1,
+        c2_input_width, c2_input_height, layout
+      ) ) );
+    }
+    if( c1_mp )
+      c1_mp_backward.reset( new layer( create_max_pooling_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_relu_mask ? c1_activation3_output : c1_conv3_output, c1_mp_output, c1_activation3_mask, c1_activation3_grad, c2_conv1_grad,
+        c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2, leaky_slope > 0.f ? leaky_slope : 0.f, layout
+      ) ) );
+    else
+      c1_activation3_backward.reset( new layer( leaky_slope > 0.f ?
+        create_leaky_relu_backward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c1_conv3_output, c1_activation3_output,
+          c1_activation3_grad, c1_mp_grad, leaky_slope
+        ) :
+        c1_relu_mask ?
+        create_relu_mask_backward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c1_activation3_mask, c1_activation3_grad, c1_mp_grad
+        ) :
+        create_relu_backward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c1_conv3_output, c1_activation3_output,
+          c1_activation3_grad, c1_mp_grad
+        )
+      ) );
     c1_conv3_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c1_activation2_output, c1_conv3_output, c1_conv3_weight, c1_conv3_grad, c1_activation3_grad,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
     c1_conv3_update_backward.reset( new layer( create_conv_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation2_output, c1_conv3_output, c1_conv3_weight, c1_activation3_grad,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_activation2_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_conv2_output, c1_activation2_output,
-      c1_activation2_grad, c1_conv3_grad
+      c1_activation2_output, c1_conv3_output, c1_conv3_weight, c1_conv3_weight_grad, c1_activation3_grad,
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c1_activation2_backward.reset( new layer( leaky_slope > 0.f ?
+      create_leaky_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_conv2_output, c1_activation2_output,
+        c1_activation2_grad, c1_conv3_grad, leaky_slope
+      ) :
+      c1_relu_mask ?
+      create_relu_mask_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_activation2_mask, c1_activation2_grad, c1_conv3_grad
+      ) :
+      create_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_conv2_output, c1_activation2_output,
+        c1_activation2_grad, c1_conv3_grad
+      )
+    ) );
     c1_conv2_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c1_activation1_output, c1_conv2_output, c1_conv2_weight, c1_conv2_grad, c1_activation2_grad,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
     c1_conv2_update_backward.reset( new layer( create_conv_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation1_output, c1_conv2_output, c1_conv2_weight, c1_activation2_grad,
-      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1
-    ) ) );
-    c1_activation1_backward.reset( new layer( create_relu_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_conv1_output, c1_activation1_output,
-      c1_activation1_grad, c1_conv2_grad
+      c1_activation1_output, c1_conv2_output, c1_conv2_weight, c1_conv2_weight_grad, c1_activation2_grad,
+      image_width, image_height, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1, layout
     ) ) );
+    c1_activation1_backward.reset( new layer( leaky_slope > 0.f ?
+      create_leaky_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        batchnorm ? c1_bn1_output : c1_fused ? c1_activation1_output : c1_conv1_output, c1_activation1_output,
+        batchnorm ? c1_bn1_grad : c1_activation1_grad, c1_conv2_grad, leaky_slope
+      ) :
+      create_relu_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        batchnorm ? c1_bn1_output : c1_conv1_output, c1_activation1_output,
+        batchnorm ? c1_bn1_grad : c1_activation1_grad, c1_conv2_grad
+      )
+    ) );
     c1_conv1_bp_backward_1.reset( new layer( create_conv2_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       batch_images[ 0 ], c1_conv1_output, c1_conv1_weight, c1_conv1_grad, c1_activation1_grad,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, 0u, 0u, layout
     ) ) );
     c1_conv1_update_backward_1.reset( new layer( create_conv_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      batch_images[ 0 ], c1_conv1_output, c1_conv1_weight, c1_activation1_grad,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      batch_images[ 0 ], c1_conv1_output, c1_conv1_weight, c1_conv1_weight_grad, c1_activation1_grad,
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, 0u, 0u, layout
     ) ) );
     c1_conv1_bp_backward_2.reset( new layer( create_conv2_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       batch_images[ 1 ], c1_conv1_output, c1_conv1_weight, c1_conv1_grad, c1_activation1_grad,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, 0u, 0u, layout
     ) ) );
     c1_conv1_update_backward_2.reset( new layer( create_conv_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      batch_images[ 1 ], c1_conv1_output, c1_conv1_weight, c1_activation1_grad,
-      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      batch_images[ 1 ], c1_conv1_output, c1_conv1_weight, c1_conv1_weight_grad, c1_activation1_grad,
+      image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1, 0u, 0u, layout
     ) ) );
-    {
-      auto &command_buffer = (*command_buffers)[ 0 ];
-      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
-      (*c1_conv1_1)( command_buffer );
-      (*c1_activation1)( command_buffer );
+    if( batchnorm ) {
+      c1_bn1.reset( new layer( create_batchnorm_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_conv1_output, c1_bn1_output, c1_bn1_weight, image_width * image_height, c1_channels, batch_size, true, layout
+      ) ) );
+      if( checkpoint )
+        c1_bn1_recompute.reset( new layer( create_batchnorm_forward_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c1_conv1_output, c1_bn1_output, c1_bn1_weight, image_width * image_height, c1_channels, batch_size, true, layout, true
+        ) ) );
+      c1_bn1_backward.reset( new layer( create_batchnorm_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_conv1_output, c1_bn1_weight, c1_activation1_grad, c1_bn1_grad, image_width * image_height, c1_channels, batch_size, layout
+      ) ) );
+      c1_bn1_fold.reset( new layer( create_batchnorm_fold_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_conv1_weight, c1_bn1_weight, c1_conv1_folded_weight, c1_conv1_bias, c1_channels
+      ) ) );
+      c1_conv1_eval.reset( new layer( create_conv_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        batch_images[ 2 ], c1_bn1_output, c1_conv1_folded_weight, c1_conv1_bias,
+        image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, 1
+      ) ) );
+      c2_bn1.reset( new layer( create_batchnorm_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_conv1_output, c2_bn1_output, c2_bn1_weight, c1_width * c1_height, c2_channels, batch_size, true, layout
+      ) ) );
+      c2_bn1_backward.reset( new layer( create_batchnorm_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_conv1_output, c2_bn1_weight, c2_activation1_grad, c2_bn1_grad, c1_width * c1_height, c2_channels, batch_size, layout
+      ) ) );
+      c2_bn1_fold.reset( new layer( create_batchnorm_fold_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_conv1_weight, c2_bn1_weight, c2_conv1_folded_weight, c2_conv1_bias, c2_channels
+      ) ) );
+      c2_conv1_eval.reset( new layer( create_conv_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_input, c2_bn1_output, c2_conv1_folded_weight, c2_conv1_bias,
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, c2_stride, c2_stride, 1, 1, 1,
+        false, leaky_slope, c2_input_width, c2_input_height
+      ) ) );
+    }
+    if( config.quantize ) {
+      const auto c1_conv1_source = batchnorm ? c1_conv1_folded_weight : c1_conv1_weight;
+      const auto c2_conv1_source = batchnorm ? c2_conv1_folded_weight : c2_conv1_weight;
+      const auto c1_conv1_eval_bias = batchnorm ? buffer_view< glm::vec4 >( c1_conv1_bias ) : buffer_view< glm::vec4 >();
+      const auto c2_conv1_eval_bias = batchnorm ? buffer_view< glm::vec4 >( c2_conv1_bias ) : buffer_view< glm::vec4 >();
+      const auto c1_conv1_range = calibrate_range( batch_images[ 2 ] );
+      const auto c1_activation1_range = calibrate_range( c1_activation1_output );
+      const auto c1_activation2_range = calibrate_range( c1_activation2_output );
+      const auto c2_activation1_range = calibrate_range( c2_activation1_output );
+      const auto c2_activation2_range = calibrate_range( c2_activation2_output );
+      const auto hidden_range = calibrate_range( c2_mp_output );
+      const auto output_range = calibrate_range( hidden_activation_output );
+      const auto [c1_conv1_q,c1_conv1_scale] = quantize_weight( c1_conv1_source, c1_channels, 9 * image_channels, 1, 9 * image_channels );
+      const auto [c1_conv2_q,c1_conv2_scale] = quantize_weight( c1_conv2_weight, c1_channels, 9, 1, 9 );
+      const auto [c1_conv3_q,c1_conv3_scale] = quantize_weight( c1_conv3_weight, c1_channels, 9, 1, 9 );
+      const auto [c2_conv2_q,c2_conv2_scale] = quantize_weight( c2_conv2_weight, c2_channels, 9, 1, 9 );
+      const auto [c2_conv3_q,c2_conv3_scale] = quantize_weight( c2_conv3_weight, c2_channels, 9, 1, 9 );
+      const auto [hidden_q,hidden_scale] = quantize_weight( hidden_weight, hidden_width, 1, hidden_width, head_width );
+      const auto [output_q,output_scale] = quantize_weight( output_weight, output_width, 1, output_width, hidden_width );
+      c1_conv1_int8.reset( new layer( create_conv_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        batch_images[ 2 ], batchnorm ? c1_bn1_output : c1_fused ? c1_activation1_output : c1_conv1_output,
+        c1_conv1_q, c1_conv1_scale, c1_conv1_eval_bias, c1_conv1_range, 0,
+        image_width, image_height, c1_channels, batch_size, 3, 3, image_channels, 1, 1, 1, 1, false, c1_fused, leaky_slope, 0u, 0u, layout
+      ) ) );
+      c1_conv2_int8.reset( new layer( create_conv_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_activation1_output, c1_conv2_output,
+        c1_conv2_q, c1_conv2_scale, buffer_view< glm::vec4 >(), c1_activation1_range, 0,
+        image_width, image_height, c1_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, true, false, leaky_slope, 0u, 0u, layout
+      ) ) );
+      c1_conv3_int8.reset( new layer( create_conv_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c1_activation2_output, c1_conv3_output,
+        c1_conv3_q, c1_conv3_scale, buffer_view< glm::vec4 >(), c1_activation2_range, 0,
+        image_width, image_height, c1_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, true, false, leaky_slope, 0u, 0u, layout
+      ) ) );
+      if( c2_conv1 ) {
+        const auto c2_conv1_range = calibrate_range( c2_input );
+        const auto [c2_conv1_q,c2_conv1_scale] = quantize_weight( c2_conv1_source, c2_channels, 9 * c1_channels, 1, 9 * c1_channels );
+        c2_conv1_int8.reset( new layer( create_conv_forward_int8_pipeline(
+          device, mods, descriptor_pool, pipeline_cache, props,
+          c2_input, batchnorm ? c2_bn1_output : c2_conv1_output,
+          c2_conv1_q, c2_conv1_scale, c2_conv1_eval_bias, c2_conv1_range, 0,
+          c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, c2_stride, c2_stride, 1, 1, false, false, leaky_slope,
+          c2_input_width, c2_input_height, layout
+        ) ) );
+      }
+      c2_conv2_int8.reset( new layer( create_conv_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_activation1_output, c2_conv2_output,
+        c2_conv2_q, c2_conv2_scale, buffer_view< glm::vec4 >(), c2_activation1_range, 0,
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, true, false, leaky_slope, 0u, 0u, layout
+      ) ) );
+      c2_conv3_int8.reset( new layer( create_conv_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_activation2_output, c2_conv3_output,
+        c2_conv3_q, c2_conv3_scale, buffer_view< glm::vec4 >(), c2_activation2_range, 0,
+        c1_width, c1_height, c2_channels, batch_size, 3, 3, c2_channels, 1, 1, 1, 1, true, false, leaky_slope, 0u, 0u, layout
+      ) ) );
+      hidden_affine_int8.reset( new layer( create_affine_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        c2_mp_output, hidden_affine_output, hidden_q, hidden_scale, hidden_bias_view, hidden_range, 0, batch_size
+      ) ) );
+      output_affine_int8.reset( new layer( create_affine_forward_int8_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        hidden_activation_output, output_affine_output, output_q, output_scale, output_bias_view, output_range, 0, batch_size
+      ) ) );
+    }
+    build_clipping();
+    auto record_c1_forward = [&]( vk::CommandBuffer &command_buffer, const std::shared_ptr< layer > &conv1, bool recompute ) {
+      (*conv1)( command_buffer );
+      if( batchnorm ) (*( recompute ? c1_bn1_recompute : c1_bn1 ))( command_buffer );
+      if( c1_activation1 ) (*c1_activation1)( command_buffer );
       (*c1_conv2)( command_buffer );
       (*c1_activation2)( command_buffer );
       (*c1_conv3)( command_buffer );
       (*c1_activation3)( command_buffer );
-      (*c1_mp)( command_buffer );
-      (*c2_conv1)( command_buffer );
+    };
+    {
+      auto &command_buffer = (*command_buffers)[ 0 ];
+      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+      record_c1_forward( command_buffer, c1_conv1_1, false );
+      if( c1_mp ) (*c1_mp)( command_buffer );
+      if( c2_conv1 ) (*c2_conv1)( command_buffer );
+      for( const auto &l: c2_separable.forward )
+        (*l)( command_buffer );
+      if( batchnorm ) (*c2_bn1)( command_buffer );
       (*c2_activation1)( command_buffer );
       (*c2_conv2)( command_buffer );
       (*c2_activation2)( command_buffer );
       (*c2_conv3)( command_buffer );
       (*c2_activation3)( command_buffer );
+      for( const auto &block: c2_residual )
+        for( const auto &l: block.forward )
+          (*l)( command_buffer );
       (*c2_mp)( command_buffer );
       (*hidden_affine)( command_buffer );
       (*hidden_activation)( command_buffer );
+      if( dropout > 0.f ) (*hidden_dropout)( command_buffer );
       (*output_affine)( command_buffer );
       (*output_activation)( command_buffer );
       (*error1)( command_buffer );
       (*output_activation_backward)( command_buffer );
       (*output_affine_backward)( command_buffer );
+      if( dropout > 0.f ) (*hidden_dropout_backward)( command_buffer );
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c2_mp_backward)( command_buffer );
-      (*c2_activation3_backward)( command_buffer );
+      for( auto block = c2_residual.rbegin(); block != c2_residual.rend(); ++block )
+        for( const auto &l: block->backward )
+          (*l)( command_buffer );
+      if( c2_activation3_backward ) (*c2_activation3_backward)( command_buffer );
       (*c2_conv3_bp_backward)( command_buffer );
       (*c2_conv3_update_backward)( command_buffer );
       (*c2_activation2_backward)( command_buffer );
       (*c2_conv2_bp_backward)( command_buffer );
       (*c2_conv2_update_backward)( command_buffer );
       (*c2_activation1_backward)( command_buffer );
-      (*c2_conv1_bp_backward)( command_buffer );
-      (*c2_conv1_update_backward)( command_buffer );
-      (*c1_mp_backward)( command_buffer );
-      (*c1_activation3_backward)( command_buffer );
+      if( batchnorm ) (*c2_bn1_backward)( command_buffer );
+      if( c2_conv1 ) {
+        (*c2_conv1_bp_backward)( command_buffer );
+        (*c2_conv1_update_backward)( command_buffer );
+      }
+      for( const auto &l: c2_separable.backward )
+        (*l)( command_buffer );
+      if( checkpoint ) record_c1_forward( command_buffer, c1_conv1_1, true );
+      if( c1_mp_backward ) (*c1_mp_backward)( command_buffer );
+      if( c1_activation3_backward ) (*c1_activation3_backward)( command_buffer );
       (*c1_conv3_bp_backward)( command_buffer );
       (*c1_conv3_update_backward)( command_buffer );
       (*c1_activation2_backward)( command_buffer );
       (*c1_conv2_bp_backward)( command_buffer );
       (*c1_conv2_update_backward)( command_buffer );
       (*c1_activation1_backward)( command_buffer );
+      if( batchnorm ) (*c1_bn1_backward)( command_buffer );
       (*c1_conv1_bp_backward_1)( command_buffer );
       (*c1_conv1_update_backward_1)( command_buffer );
+      clip( command_buffer );
       command_buffer.end();
     }
     {
       auto &command_buffer = (*command_buffers)[ 1 ];
       command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
-      (*c1_conv1_2)( command_buffer );
-      (*c1_activation1)( command_buffer );
-      (*c1_conv2)( command_buffer );
-      (*c1_activation2)( command_buffer );
-      (*c1_conv3)( command_buffer );
-      (*c1_activation3)( command_buffer );
-      (*c1_mp)( command_buffer );
-      (*c2_conv1)( command_buffer );
+      record_c1_forward( command_buffer, c1_conv1_2, false );
+      if( c1_mp ) (*c1_mp)( command_buffer );
+      if( c2_conv1 ) (*c2_conv1)( command_buffer );
+      for( const auto &l: c2_separable.forward )
+        (*l)( command_buffer );
+      if( batchnorm ) (*c2_bn1)( command_buffer );
       (*c2_activation1)( command_buffer );
       (*c2_conv2)( command_buffer );
       (*c2_activation2)( command_buffer );
       (*c2_conv3)( command_buffer );
       (*c2_activation3)( command_buffer );
+      for( const auto &block: c2_residual )
+        for( const auto &l: block.forward )
+          (*l)( command_buffer );
       (*c2_mp)( command_buffer );
       (*hidden_affine)( command_buffer );
       (*hidden_activation)( command_buffer );
+      if( dropout > 0.f ) (*hidden_dropout)( command_buffer );
       (*output_affine)( command_buffer );
       (*output_activation)( command_buffer );
       (*error2)( command_buffer );
       (*output_activation_backward)( command_buffer );
       (*output_affine_backward)( command_buffer );
+      if( dropout > 0.f ) (*hidden_dropout_backward)( command_buffer );
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c2_mp_backward)( command_buffer );
-      (*c2_activation3_backward)( command_buffer );
+      for( auto block = c2_residual.rbegin(); block != c2_residual.rend(); ++block )
+        for( const auto &l: block->backward )
+          (*l)( command_buffer );
+      if( c2_activation3_backward ) (*c2_activation3_backward)( command_buffer );
       (*c2_conv3_bp_backward)( command_buffer );
       (*c2_conv3_update_backward)( command_buffer );
       (*c2_activation2_backward)( command_buffer );
       (*c2_conv2_bp_backward)( command_buffer );
       (*c2_conv2_update_backward)( command_buffer );
       (*c2_activation1_backward)( command_buffer );
-      (*c2_conv1_bp_backward)( command_buffer );
-      (*c2_conv1_update_backward)( command_buffer );
-      (*c1_mp_backward)( command_buffer );
-      (*c1_activation3_backward)( command_buffer );
+      if( batchnorm ) (*c2_bn1_backward)( command_buffer );
+      if( c2_conv1 ) {
+        (*c2_conv1_bp_backward)( command_buffer );
+        (*c2_conv1_update_backward)( command_buffer );
+      }
+      for( const auto &l: c2_separable.backward )
+        (*l)( command_buffer );
+      if( checkpoint ) record_c1_forward( command_buffer, c1_conv1_2, true );
+      if( c1_mp_backward ) (*c1_mp_backward)( command_buffer );
+      if( c1_activation3_backward ) (*c1_activation3_backward)( command_buffer );
       (*c1_conv3_bp_backward)( command_buffer );
       (*c1_conv3_update_backward)( command_buffer );
       (*c1_activation2_backward)( command_buffer );
       (*c1_conv2_bp_backward)( command_buffer );
       (*c1_conv2_update_backward)( command_buffer );
       (*c1_activation1_backward)( command_buffer );
+      if( batchnorm ) (*c1_bn1_backward)( command_buffer );
       (*c1_conv1_bp_backward_2)( command_buffer );
       (*c1_conv1_update_backward_2)( command_buffer );
+      clip( command_buffer );
       command_buffer.end();
     }
+    auto record_eval = [&]( vk::CommandBuffer &command_buffer ) {
+      if( c1_block ) (*c1_block)( command_buffer );
+      else {
+        if( batchnorm ) {
+          (*c1_bn1_fold)( command_buffer );
+          (*c1_conv1_eval)( command_buffer );
+        }
+        else
+          (*c1_conv1_3)( command_buffer );
+        if( c1_activation1 ) (*c1_activation1)( command_buffer );
+        (*c1_conv2)( command_buffer );
+        (*c1_activation2)( command_buffer );
+        (*c1_conv3)( command_buffer );
+        (*c1_activation3)( command_buffer );
+        if( c1_mp ) (*c1_mp)( command_buffer );
+      }
+      if( batchnorm ) {
+        (*c2_bn1_fold)( command_buffer );
+        (*c2_conv1_eval)( command_buffer );
+      }
+      else {
+        if( c2_conv1 ) (*c2_conv1)( command_buffer );
+        for( const auto &l: c2_separable.forward )
+          (*l)( command_buffer );
+      }
+      (*c2_activation1)( command_buffer );
+      (*c2_conv2)( command_buffer );
+      (*c2_activation2)( command_buffer );
+      (*c2_conv3)( command_buffer );
+      (*c2_activation3)( command_buffer );
+      for( const auto &block: c2_residual )
+        for( const auto &l: block.forward )
+          (*l)( command_buffer );
+      (*c2_mp)( command_buffer );
+      (*hidden_affine)( command_buffer );
+      (*hidden_activation)( command_buffer );
+      if( dropout > 0.f ) (*output_affine_eval)( command_buffer );
+      else (*output_affine)( command_buffer );
+      (*output_activation3)( command_buffer );
+    };
     {
       auto &command_buffer = (*command_buffers)[ 2 ];
       command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
-      (*c1_conv1_3)( command_buffer );
-      (*c1_activation1)( command_buffer );
-      (*c1_conv2)( command_buffer );
+      record_eval( command_buffer );
+      command_buffer.end();
+    }
+    if( config.quantize ) {
+      auto &command_buffer = (*command_buffers)[ 4 ];
+      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+      record_eval( command_buffer );
+      for( const auto &l: calibration )
+        (*l)( command_buffer );
+      command_buffer.end();
+    }
+    if( config.quantize ) {
+      auto &command_buffer = (*command_buffers)[ 5 ];
+      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+      (*c1_conv1_int8)( command_buffer );
+      if( c1_activation1 ) (*c1_activation1)( command_buffer );
+      (*c1_conv2_int8)( command_buffer );
       (*c1_activation2)( command_buffer );
-      (*c1_conv3)( command_buffer );
+      (*c1_conv3_int8)( command_buffer );
       (*c1_activation3)( command_buffer );
-      (*c1_mp)( command_buffer );
-      (*c2_conv1)( command_buffer );
+      if( c1_mp ) (*c1_mp)( command_buffer );
+      if( c2_conv1_int8 ) (*c2_conv1_int8)( command_buffer );
+      for( const auto &l: c2_separable.forward )
+        (*l)( command_buffer );
       (*c2_activation1)( command_buffer );
-      (*c2_conv2)( command_buffer );
+      (*c2_conv2_int8)( command_buffer );
       (*c2_activation2)( command_buffer );
-      (*c2_conv3)( command_buffer );
+      (*c2_conv3_int8)( command_buffer );
       (*c2_activation3)( command_buffer );
+      for( const auto &block: c2_residual )
+        for( const auto &l: block.forward )
+          (*l)( command_buffer );
       (*c2_mp)( command_buffer );
-      (*hidden_affine)( command_buffer );
+      (*hidden_affine_int8)( command_buffer );
       (*hidden_activation)( command_buffer );
-      (*output_affine)( command_buffer );
+      (*output_affine_int8)( command_buffer );
       (*output_activation3)( command_buffer );
       command_buffer.end();
     }
@@ -62,28 +62,28 @@ namespace liblnn {
         .setSize( 3 * 3 * image_channels * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv1_weight, image_width * image_height * image_channels );
+    weights.emplace_back( c1_conv1_weight, 3 * 3 * image_channels, init_type::he );
     c1_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv2_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv2_weight, 3 * 3, init_type::he );
     hidden_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( image_width * image_height * c1_channels * hidden_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( hidden_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( hidden_weight, image_width * image_height * c1_channels, init_type::he );
     output_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * output_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( output_weight, hidden_width );
+    weights.emplace_back( output_weight, hidden_width, init_type::he );
     c1_conv1_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -63,35 +63,35 @@ namespace liblnn {
         .setSize( 3 * 3 * image_channels * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv1_weight, image_width * image_height * image_channels );
+    weights.emplace_back( c1_conv1_weight, 3 * 3 * image_channels, init_type::he );
     c1_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv2_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv2_weight, 3 * 3, init_type::he );
     c1_conv3_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv3_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv3_weight, 3 * 3, init_type::he );
     hidden_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( c1_width * c1_height * c1_channels * hidden_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( hidden_weight, c1_width * c1_height * c1_channels );
+    weights.emplace_back( hidden_weight, c1_width * c1_height * c1_channels, init_type::he );
     output_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * output_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( output_weight, hidden_width );
+    weights.emplace_back( output_weight, hidden_width, init_type::he );
     c1_conv1_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -210,17 +210,10 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "hidden_affine_grad" ), hidden_affine_grad ) );
-    c1_mp_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
-    ) );
-    buffers.insert( std::make_pair( std::string( "c1_mp_grad" ), c1_mp_grad ) );
     c1_activation3_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c1_mp_grad->size() * sizeof( float ) )
+        .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c1_activation3_grad" ), c1_activation3_grad ) );
@@ -341,15 +334,10 @@ namespace liblnn {
       hidden_affine_grad, hidden_activation_grad,
       batch_size
     ) ) );
-    c1_mp_backward.reset( new layer( create_max_pooling_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation3_output, c1_mp_output, c1_mp_grad, hidden_affine_grad,
-      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2
-    ) ) );
-    c1_activation3_backward.reset( new layer( create_relu_backward_pipeline(
+    c1_mp_backward.reset( new layer( create_max_pooling_relu_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c1_conv3_output, c1_activation3_output,
-      c1_activation3_grad, c1_mp_grad
+      c1_conv3_output, c1_mp_output, buffer_view< float >(), c1_activation3_grad, hidden_affine_grad,
+      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2, 0.f
     ) ) );
     c1_conv3_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
@@ -421,7 +409,6 @@ namespace liblnn {
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c1_mp_backward)( command_buffer );
-      (*c1_activation3_backward)( command_buffer );
       (*c1_conv3_bp_backward)( command_buffer );
       (*c1_conv3_update_backward)( command_buffer );
       (*c1_activation2_backward)( command_buffer );
@@ -452,7 +439,6 @@ namespace liblnn {
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c1_mp_backward)( command_buffer );
-      (*c1_activation3_backward)( command_buffer );
       (*c1_conv3_bp_backward)( command_buffer );
       (*c1_conv3_update_backward)( command_buffer );
       (*c1_activation2_backward)( command_buffer );
@@ -64,42 +64,42 @@ namespace liblnn {
         .setSize( 3 * 3 * image_channels * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv1_weight, image_width * image_height * image_channels );
+    weights.emplace_back( c1_conv1_weight, 3 * 3 * image_channels, init_type::he );
     c1_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c1_conv2_weight, image_width * image_height * c1_channels );
+    weights.emplace_back( c1_conv2_weight, 3 * 3, init_type::he );
     c2_conv1_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c1_channels * c2_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c2_conv1_weight, c1_width * c1_height *c1_channels );
+    weights.emplace_back( c2_conv1_weight, 3 * 3 * c1_channels, init_type::he );
     c2_conv2_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( 3 * 3 * c2_channels * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( c2_conv2_weight, c1_width * c1_height * c2_channels );
+    weights.emplace_back( c2_conv2_weight, 3 * 3, init_type::he );
     hidden_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( c2_width * c2_height * c2_channels * hidden_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( hidden_weight, c2_channels * c2_height * c2_channels );
+    weights.emplace_back( hidden_weight, c2_width * c2_height * c2_channels, init_type::he );
     output_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * output_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( output_weight, hidden_width );
+    weights.emplace_back( output_weight, hidden_width, init_type::he );
     c1_conv1_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -240,17 +240,10 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "hidden_affine_grad" ), hidden_affine_grad ) );
-    c2_mp_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( c1_width * c1_height * c2_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
-    ) );
-    buffers.insert( std::make_pair( std::string( "c2_mp_grad" ), c2_mp_grad ) );
     c2_activation2_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c2_mp_grad->size() * sizeof( float ) )
+        .setSize( c1_width * c1_height * c2_channels * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c2_activation2_grad" ), c2_activation2_grad ) );
@@ -275,17 +268,10 @@ namespace liblnn {
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c2_conv1_grad" ), c2_conv1_grad ) );
-    c1_mp_grad.reset( new liblnn::buffer< float >(
-      allocator, buf_type,
-      vk::BufferCreateInfo()
-        .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
-        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
-    ) );
-    buffers.insert( std::make_pair( std::string( "c1_mp_grad" ), c1_mp_grad ) );
     c1_activation2_grad.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
-        .setSize( c1_mp_grad->size() * sizeof( float ) )
+        .setSize( image_width * image_height * c1_channels * batch_size * sizeof( float ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
     ) );
     buffers.insert( std::make_pair( std::string( "c1_activation2_grad" ), c1_activation2_grad ) );
@@ -402,14 +388,10 @@ namespace liblnn {
     hidden_affine_backward.reset( new layer( create_affine_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props, c2_mp_output, hidden_affine_output, hidden_weight, hidden_affine_grad, hidden_activation_grad, batch_size
     ) ) );
-    c2_mp_backward.reset( new layer( create_max_pooling_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c2_activation2_output, c2_mp_output, c2_mp_grad, hidden_affine_grad,
-      c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2 ) ) );
-    c2_activation2_backward.reset( new layer( create_relu_backward_pipeline(
+    c2_mp_backward.reset( new layer( create_max_pooling_relu_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c2_conv2_output, c2_activation2_output, c2_activation2_grad, c2_mp_grad
-    ) ) );
+      c2_conv2_output, c2_mp_output, buffer_view< float >(), c2_activation2_grad, hidden_affine_grad,
+      c2_width, c2_height, c2_channels, batch_size, 2, 2, 2, 2, 0.f ) ) );
     c2_conv2_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c2_activation1_output, c2_conv2_output, c2_conv2_weight, c2_conv2_grad, c2_activation2_grad,
@@ -430,14 +412,10 @@ namespace liblnn {
       device, mods, descriptor_pool, pipeline_cache, props,
       c1_mp_output, c2_conv1_output, c2_conv1_weight, c2_activation1_grad,
       c1_width, c1_height, c2_channels, batch_size, 3, 3, c1_channels, 1, 1, 1, 1, 1 ) ) );
-    c1_mp_backward.reset( new layer( create_max_pooling_backward_pipeline(
-      device, mods, descriptor_pool, pipeline_cache, props,
-      c1_activation2_output, c1_mp_output, c1_mp_grad, c2_conv1_grad,
-      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2 ) ) );
-    c1_activation2_backward.reset( new layer( create_relu_backward_pipeline(
+    c1_mp_backward.reset( new layer( create_max_pooling_relu_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
-      c1_conv2_output, c1_activation2_output, c1_activation2_grad, c1_mp_grad
-    ) ) );
+      c1_conv2_output, c1_mp_output, buffer_view< float >(), c1_activation2_grad, c2_conv1_grad,
+      c1_width, c1_height, c1_channels, batch_size, 2, 2, 2, 2, 0.f ) ) );
     c1_conv2_bp_backward.reset( new layer( create_conv2_straight_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props,
       c1_activation1_output, c1_conv2_output, c1_conv2_weight, c1_conv2_grad, c1_activation2_grad,
@@ -493,14 +471,12 @@ namespace liblnn {
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c2_mp_backward)( command_buffer );
-      (*c2_activation2_backward)( command_buffer );
       (*c2_conv2_bp_backward)( command_buffer );
       (*c2_conv2_update_backward)( command_buffer );
       (*c2_activation1_backward)( command_buffer );
       (*c2_conv1_bp_backward)( command_buffer );
       (*c2_conv1_update_backward)( command_buffer );
       (*c1_mp_backward)( command_buffer );
-      (*c1_activation2_backward)( command_buffer );
       (*c1_conv2_bp_backward)( command_buffer );
       (*c1_conv2_update_backward)( command_buffer );
       (*c1_activation1_backward)( command_buffer );
@@ -531,14 +507,12 @@ namespace liblnn {
       (*hidden_activation_backward)( command_buffer );
       (*hidden_affine_backward)( command_buffer );
       (*c2_mp_backward)( command_buffer );
-      (*c2_activation2_backward)( command_buffer );
       (*c2_conv2_bp_backward)( command_buffer );
       (*c2_conv2_update_backward)( command_buffer );
       (*c2_activation1_backward)( command_buffer );
       (*c2_conv1_bp_backward)( command_buffer );
       (*c2_conv1_update_backward)( command_buffer );
       (*c1_mp_backward)( command_buffer );
-      (*c1_activation2_backward)( command_buffer );
       (*c1_conv2_bp_backward)( command_buffer );
       (*c1_conv2_update_backward)( command_buffer );
       (*c1_activation1_backward)( command_buffer );
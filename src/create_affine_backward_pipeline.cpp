@@ -40,6 +40,9 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &bias_grad,
     const buffer_view< float > &input_grad,
     const buffer_view< float > &output_grad,
     size_t batch_size
@@ -74,23 +77,47 @@ namespace liblnn {
         .setDescriptorCount( 1 )
         .setBinding( 4 )
         .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 6 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 14 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
         .setPImmutableSamplers( nullptr )
     };
+    const bool deferred_update = bool( weight_grad );
+    const bool bf16_grad = deferred_update && weight_grad.size() != weight.size();
+    if( bf16_grad && weight_grad.size() != ( weight.size() + 1 ) / 2 ) throw invalid_data_length();
+    const bool use_bias = bool( bias );
+    if( use_bias && bias.size() != height ) throw invalid_data_length();
+    if( use_bias && deferred_update && bias_grad.size() != bias.size() ) throw invalid_data_length();
     const uint32_t width = input_grad.size() / batch_size;
     const uint32_t height = output_grad.size() / batch_size;
     const uint32_t system_max = std::min( props.props.limits.maxComputeWorkGroupSize[ 1 ], props.props.limits.maxComputeWorkGroupCount[ 1 ] );
-    if( batch_size > props.props.limits.maxComputeWorkGroupCount[ 2 ] ) throw too_large_data();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto aligned_height = ( height / props.subgroup_props.subgroupSize + ( ( height % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 5 > spec_data{ std::min( aligned_height, system_max ), 1, height, aligned_height / props.subgroup_props.subgroupSize, uint32_t( batch_size ) };
-    std::array< vk::SpecializationMapEntry, 5 > spec_ent {
+    const auto tuning = get_tuning_entry( props, "affine_backward", { width, height, uint32_t( batch_size ), uint32_t( deferred_update ), uint32_t( use_bias ), uint32_t( bf16_grad ) }, std::min( aligned_height, system_max ), std::min( aligned_height, system_max ) );
+    std::array< uint32_t, 9 > spec_data{ tuning.local_size, 1, height, aligned_height / props.subgroup_props.subgroupSize, uint32_t( batch_size ), deferred_update, use_bias, get_subgroup_size( props ), bf16_grad };
+    std::array< vk::SpecializationMapEntry, 9 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -110,6 +137,22 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 5 )
         .setOffset( 16 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 6 )
+        .setOffset( 20 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 7 )
+        .setOffset( 24 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 8 )
+        .setOffset( 28 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 9 )
+        .setOffset( 32 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -122,8 +165,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props, spec_data[ 0 ] )
               .setModule( *mods.affine_backward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -159,6 +201,24 @@ namespace liblnn {
       .setBuffer( output_grad.get() )
       .setOffset( output_grad.offset() * sizeof( float ) )
       .setRange( output_grad.size() * sizeof( float ) );
+    auto weight_grad_dbi = deferred_update ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( weight_grad.get() )
+        .setOffset( weight_grad.offset() * sizeof( float ) )
+        .setRange( weight_grad.size() * sizeof( float ) ) :
+      output_grad_dbi;
+    auto bias_dbi = use_bias ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias.get() )
+        .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+        .setRange( bias.size() * sizeof( glm::vec4 ) ) :
+      weight_dbi;
+    auto bias_grad_dbi = use_bias && deferred_update ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias_grad.get() )
+        .setOffset( bias_grad.offset() * sizeof( float ) )
+        .setRange( bias_grad.size() * sizeof( float ) ) :
+      output_grad_dbi;
     device->updateDescriptorSets(
       std::vector< vk::WriteDescriptorSet >{
          vk::WriteDescriptorSet()
@@ -190,7 +250,25 @@ namespace liblnn {
            .setDstBinding( 4 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &output_grad_dbi )
+           .setPBufferInfo( &output_grad_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 6 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &weight_grad_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 14 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_grad_dbi )
       },
       nullptr
     );
@@ -200,11 +278,54 @@ namespace liblnn {
       .set_weight( weight )
       .set_input_grad( input_grad )
       .set_output_grad( output_grad )
+      .set_weight_grad( weight_grad )
+      .set_bias( bias )
+      .set_bias_grad( bias_grad )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( width, 1, 1 ) );
+      .set_dispatch_size( width, 1, 1 )
+      .set_tuning( tuning ) );
+  }
+  layer create_affine_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    size_t batch_size
+  ) {
+    return create_affine_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, buffer_view< float >(), input_grad, output_grad,
+      batch_size
+    );
+  }
+  layer create_affine_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    size_t batch_size
+  ) {
+    return create_affine_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, weight_grad, buffer_view< glm::vec4 >(), buffer_view< float >(), input_grad, output_grad,
+      batch_size
+    );
   }
 }
 
@@ -0,0 +1,249 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <glm/vec4.hpp>
+#include <liblnn/layer_def.h>
+#include <liblnn/descriptor_set.h>
+#include <liblnn/pipeline_layout.h>
+#include <liblnn/exceptions.h>
+#include <liblnn/pipeline.h>
+
+namespace liblnn {
+  layer create_affine_forward_int8_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &quantized_weight,
+    const buffer_view< float > &weight_scale,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &activation_range,
+    uint32_t slot,
+    size_t batch_size
+  ) {
+    const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 0 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 1 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 16 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 17 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 18 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr )
+    };
+    const uint32_t width = input_value.size() / batch_size;
+    const uint32_t height = output_value.size() / batch_size;
+    const uint32_t system_max = std::min( props.props.limits.maxComputeWorkGroupSize[ 0 ], props.props.limits.maxComputeWorkGroupCount[ 0 ] );
+    if( quantized_weight.size() != height * ( ( width + 3 ) / 4 ) ) throw invalid_data_length();
+    if( weight_scale.size() != height ) throw invalid_data_length();
+    if( slot >= activation_range.size() ) throw invalid_data_length();
+    const bool use_bias = bool( bias );
+    if( use_bias && bias.size() != height ) throw invalid_data_length();
+    auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
+    std::vector< vk::PushConstantRange > push_constant_range{
+      vk::PushConstantRange()
+       .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+       .setOffset( 0 )
+       .setSize( 12 )
+    };
+    auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
+    auto aligned_width = ( width / props.subgroup_props.subgroupSize + ( ( width % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
+    const auto tuning = get_tuning_entry( props, "affine_forward_int8", { width, height }, std::min( aligned_width, system_max ), std::min( aligned_width, system_max ) );
+    std::array< uint32_t, 8 > spec_data{ tuning.local_size, 1, width, aligned_width / props.subgroup_props.subgroupSize, use_bias, slot, get_subgroup_size( props ), height };
+    std::array< vk::SpecializationMapEntry, 8 > spec_ent{
+      vk::SpecializationMapEntry()
+        .setConstantID( 1 )
+        .setOffset( 0 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 2 )
+        .setOffset( 4 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 3 )
+        .setOffset( 8 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 4 )
+        .setOffset( 12 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 5 )
+        .setOffset( 16 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 6 )
+        .setOffset( 20 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 7 )
+        .setOffset( 24 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 8 )
+        .setOffset( 28 )
+        .setSize( 4 )
+    };
+    auto spec = vk::SpecializationInfo()
+      .setMapEntryCount( spec_ent.size() )
+      .setPMapEntries( spec_ent.data() )
+      .setDataSize( spec_data.size() * sizeof( uint32_t ) )
+      .setPData( spec_data.data() );
+    auto pipelines = device->createComputePipelines(
+      *pipeline_cache,
+      std::vector< vk::ComputePipelineCreateInfo >{
+        vk::ComputePipelineCreateInfo()
+          .setStage(
+            get_shader_stage( props, spec_data[ 0 ] )
+              .setModule( *mods.affine_forward_int8 )
+              .setPName( "main" )
+              .setPSpecializationInfo( &spec )
+          )
+          .setLayout( *pipeline_layout )
+      }
+    );
+    std::shared_ptr< vk::Pipeline > pipeline(
+      new vk::Pipeline( std::move( pipelines[ 0 ] ) ),
+      [device,pipeline_cache,module=mods.affine_forward_int8,pipeline_layout]( vk::Pipeline *p ) {
+        if( p ) device->destroyPipeline( *p );
+        delete p;
+      }
+    );
+
+    auto input_value_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( input_value.get() )
+      .setOffset( input_value.offset() * sizeof( float ) )
+      .setRange( input_value.size() * sizeof( float ) );
+    auto output_value_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( output_value.get() )
+      .setOffset( output_value.offset() * sizeof( float ) )
+      .setRange( output_value.size() * sizeof( float ) );
+    auto quantized_weight_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( quantized_weight.get() )
+      .setOffset( quantized_weight.offset() * sizeof( float ) )
+      .setRange( quantized_weight.size() * sizeof( float ) );
+    auto weight_scale_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( weight_scale.get() )
+      .setOffset( weight_scale.offset() * sizeof( float ) )
+      .setRange( weight_scale.size() * sizeof( float ) );
+    auto activation_range_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( activation_range.get() )
+      .setOffset( activation_range.offset() * sizeof( float ) )
+      .setRange( activation_range.size() * sizeof( float ) );
+    auto bias_dbi = use_bias ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias.get() )
+        .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+        .setRange( bias.size() * sizeof( glm::vec4 ) ) :
+      weight_scale_dbi;
+    device->updateDescriptorSets(
+      std::vector< vk::WriteDescriptorSet >{
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 0 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &input_value_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 1 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &output_value_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 16 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &quantized_weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 17 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &weight_scale_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 18 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &activation_range_dbi )
+      },
+      nullptr
+    );
+    return layer( layer_def()
+      .set_input_value( input_value )
+      .set_output_value( output_value )
+      .set_bias( bias )
+      .set_quantized_weight( quantized_weight )
+      .set_weight_scale( weight_scale )
+      .set_activation_range( activation_range )
+      .set_descriptor_set( descriptor_set )
+      .set_pipeline( pipeline )
+      .set_descriptor_set_layout( descriptor_set_layout )
+      .set_pipeline_layout( pipeline_layout )
+      .set_dispatch_size( 1, height, batch_size )
+      .set_tuning( tuning ) );
+  }
+}
+
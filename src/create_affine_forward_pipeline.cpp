@@ -41,6 +41,7 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
     size_t batch_size
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
@@ -61,25 +62,32 @@ namespace liblnn {
         .setDescriptorCount( 1 )
         .setBinding( 2 )
         .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
         .setPImmutableSamplers( nullptr )
     };
     const uint32_t width = input_value.size() / batch_size;
     const uint32_t height = output_value.size() / batch_size;
     const uint32_t system_max = std::min( props.props.limits.maxComputeWorkGroupSize[ 0 ], props.props.limits.maxComputeWorkGroupCount[ 0 ] );
-    if( batch_size > props.props.limits.maxComputeWorkGroupCount[ 2 ] ) throw too_large_data();
     if( weight.size() != width * height ) throw invalid_data_length();
+    const bool use_bias = bool( bias );
+    if( use_bias && bias.size() != height ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto aligned_width = ( width / props.subgroup_props.subgroupSize + ( ( width % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::cout << "width: " << width << " height: " << height << " " << " aligned_width: " << aligned_width << std::endl;
-    std::array< uint32_t, 4 > spec_data{ std::min( aligned_width, system_max ), 1, width, aligned_width / props.subgroup_props.subgroupSize };
-    std::array< vk::SpecializationMapEntry, 4 > spec_ent {
+    const auto tuning = get_tuning_entry( props, "affine_forward", { width, height }, std::min( aligned_width, system_max ), std::min( aligned_width, system_max ) );
+    std::array< uint32_t, 7 > spec_data{ tuning.local_size, 1, width, aligned_width / props.subgroup_props.subgroupSize, use_bias, get_subgroup_size( props ), height };
+    std::array< vk::SpecializationMapEntry, 7 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -93,8 +101,20 @@ namespace liblnn {
         .setOffset( 8 )
         .setSize( 4 ),
       vk::SpecializationMapEntry()
-        .setConstantID( 3 )
+        .setConstantID( 4 )
         .setOffset( 12 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 5 )
+        .setOffset( 16 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 6 )
+        .setOffset( 20 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 7 )
+        .setOffset( 24 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -107,8 +127,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props, spec_data[ 0 ] )
               .setModule( *mods.affine_forward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -136,6 +155,12 @@ namespace liblnn {
       .setBuffer( weight.get() )
       .setOffset( weight.offset() * sizeof( glm::vec4 ) )
       .setRange( width * height * sizeof( glm::vec4 ) );
+    auto bias_dbi = use_bias ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias.get() )
+        .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+        .setRange( bias.size() * sizeof( glm::vec4 ) ) :
+      weight_dbi;
     device->updateDescriptorSets(
       std::vector< vk::WriteDescriptorSet >{
          vk::WriteDescriptorSet()
@@ -155,7 +180,13 @@ namespace liblnn {
            .setDstBinding( 2 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &weight_dbi )
+           .setPBufferInfo( &weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi )
       },
       nullptr
     );
@@ -163,11 +194,30 @@ namespace liblnn {
       .set_input_value( input_value )
       .set_output_value( output_value )
       .set_weight( weight )
+      .set_bias( bias )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( 1, height, batch_size ) );
+      .set_dispatch_size( 1, height, batch_size )
+      .set_tuning( tuning ) );
+  }
+  layer create_affine_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    size_t batch_size
+  ) {
+    return create_affine_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, buffer_view< glm::vec4 >(),
+      batch_size
+    );
   }
 }
 
@@ -0,0 +1,192 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <glm/vec4.hpp>
+#include <liblnn/layer_def.h>
+#include <liblnn/descriptor_set.h>
+#include <liblnn/pipeline_layout.h>
+#include <liblnn/exceptions.h>
+#include <liblnn/pipeline.h>
+
+namespace liblnn {
+  layer create_batchnorm_fold_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< glm::vec4 > &source_weight,
+    const buffer_view< glm::vec4 > &batchnorm,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
+    uint32_t channels
+  ) {
+    const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 2 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 8 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 9 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr )
+    };
+
+    if( source_weight.size() % channels ) throw invalid_data_length();
+    if( weight.size() != source_weight.size() ) throw invalid_data_length();
+    if( bias.size() != channels ) throw invalid_data_length();
+    if( batchnorm.size() != channels * 3 ) throw invalid_data_length();
+    const uint32_t filter_size = source_weight.size() / channels;
+    const uint32_t size = weight.size();
+    const auto tuning = get_tuning_entry( props, "batchnorm_fold", { filter_size, channels }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
+    std::vector< vk::PushConstantRange > push_constant_range{
+      vk::PushConstantRange()
+       .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+       .setOffset( 0 )
+       .setSize( 12 )
+    };
+    auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
+    std::array< uint32_t, 4 > spec_data{ local_group_size, 1, filter_size, channels };
+    std::array< vk::SpecializationMapEntry, 4 > spec_ent{
+      vk::SpecializationMapEntry()
+        .setConstantID( 1 )
+        .setOffset( 0 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 2 )
+        .setOffset( 4 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 3 )
+        .setOffset( 8 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 4 )
+        .setOffset( 12 )
+        .setSize( 4 )
+    };
+    auto spec = vk::SpecializationInfo()
+      .setMapEntryCount( spec_ent.size() )
+      .setPMapEntries( spec_ent.data() )
+      .setDataSize( spec_data.size() * sizeof( uint32_t ) )
+      .setPData( spec_data.data() );
+    auto pipelines = device->createComputePipelines(
+      *pipeline_cache,
+      std::vector< vk::ComputePipelineCreateInfo >{
+        vk::ComputePipelineCreateInfo()
+          .setStage(
+            get_shader_stage( props )
+              .setModule( *mods.batchnorm_fold )
+              .setPName( "main" )
+              .setPSpecializationInfo( &spec )
+          )
+          .setLayout( *pipeline_layout )
+      }
+    );
+    std::shared_ptr< vk::Pipeline > pipeline(
+      new vk::Pipeline( std::move( pipelines[ 0 ] ) ),
+      [device,pipeline_cache,module=mods.batchnorm_fold,pipeline_layout]( vk::Pipeline *p ) {
+        if( p ) device->destroyPipeline( *p );
+        delete p;
+      }
+    );
+
+    auto weight_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( weight.get() )
+      .setOffset( weight.offset() * sizeof( glm::vec4 ) )
+      .setRange( weight.size() * sizeof( glm::vec4 ) );
+    auto bias_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( bias.get() )
+      .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+      .setRange( bias.size() * sizeof( glm::vec4 ) );
+    auto source_weight_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( source_weight.get() )
+      .setOffset( source_weight.offset() * sizeof( glm::vec4 ) )
+      .setRange( source_weight.size() * sizeof( glm::vec4 ) );
+    auto batchnorm_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( batchnorm.get() )
+      .setOffset( batchnorm.offset() * sizeof( glm::vec4 ) )
+      .setRange( batchnorm.size() * sizeof( glm::vec4 ) );
+    device->updateDescriptorSets(
+      std::vector< vk::WriteDescriptorSet >{
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 2 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 8 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &source_weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 9 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &batchnorm_dbi )
+      },
+      nullptr
+    );
+    return layer( layer_def()
+      .set_weight( weight )
+      .set_bias( bias )
+      .set_descriptor_set( descriptor_set )
+      .set_pipeline( pipeline )
+      .set_descriptor_set_layout( descriptor_set_layout )
+      .set_pipeline_layout( pipeline_layout )
+      .set_dispatch_size( aligned_size / local_group_size, 1, 1 )
+      .set_tuning( tuning ) );
+  }
+}
+
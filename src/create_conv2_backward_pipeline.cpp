@@ -43,6 +43,7 @@ namespace liblnn {
     const buffer_view< glm::vec4 > &weight,
     const buffer_view< float > &input_grad,
     const buffer_view< float > &output_grad,
+    const buffer_view< float > &shortcut_grad,
     uint32_t output_width,
     uint32_t output_height,
     uint32_t output_channels,
@@ -54,8 +55,22 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    uint32_t input_width,
+    uint32_t input_height,
+    tensor_layout layout
   ) {
+    if(
+      filter_width == 1 && filter_height == 1 && filter_xstride == 1 && filter_ystride == 1 && input_xmargin == 0 && input_ymargin == 0 &&
+      ( !input_width || input_width == output_width ) && ( !input_height || input_height == output_height ) &&
+      !shortcut_grad &&
+      input_value.size() == output_width * output_height * input_channels * batch_size
+    )
+      return create_pointwise2_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input_value, output_value, weight, input_grad, output_grad,
+        output_width * output_height, output_channels, batch_size, input_channels, layout
+      );
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
         .setDescriptorType( vk::DescriptorType::eStorageBuffer )
@@ -86,22 +101,31 @@ namespace liblnn {
         .setDescriptorCount( 1 )
         .setBinding( 4 )
         .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 11 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
         .setPImmutableSamplers( nullptr )
     };
-    const uint32_t input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
-    const uint32_t input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
+    if( !input_width ) input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
+    if( !input_height ) input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
+    if( ( output_width - 1 ) * filter_xstride >= input_width + input_xmargin ) throw invalid_data_length();
+    if( ( output_height - 1 ) * filter_ystride >= input_height + input_ymargin ) throw invalid_data_length();
     const uint32_t input_data_size = input_width * input_height * input_channels;
     const uint32_t output_data_size = output_width * output_height * output_channels;
     const uint32_t weight_size = filter_width * filter_height * input_channels * output_channels;
-    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    if( input_value.size() != input_data_size * batch_size && input_value.size() != ( input_data_size * batch_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
     if( weight.size() != weight_size ) throw invalid_data_length();
+    if( shortcut_grad && shortcut_grad.size() != input_grad.size() ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
 /*
   륰롼פΥϥХå˹碌
@@ -125,15 +149,21 @@ namespace liblnn {
 
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto size = input_width * input_height * input_channels;
-    auto aligned_size = ( size / props.subgroup_props.subgroupSize + ( ( size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 12 > spec_data{
-      props.subgroup_props.subgroupSize, 1,
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv2_backward", { output_width, output_height, output_channels, filter_width, filter_height, input_channels, input_width, input_height, uint32_t( channels_last ) }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    const bool use_shortcut = bool( shortcut_grad );
+    std::array< uint32_t, 16 > spec_data{
+      local_group_size, 1,
       output_width, output_height, output_channels,
       filter_width, filter_height, input_channels,
       filter_xstride, filter_ystride,
-      input_xmargin, input_ymargin
+      input_xmargin, input_ymargin,
+      input_width, input_height,
+      channels_last, use_shortcut
     };
-    std::array< vk::SpecializationMapEntry, 12 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 16 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -182,6 +212,22 @@ namespace liblnn {
         .setConstantID( 12 )
         .setOffset( 44 )
         .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 13 )
+        .setOffset( 48 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 14 )
+        .setOffset( 52 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 15 )
+        .setOffset( 56 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 16 )
+        .setOffset( 60 )
+        .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
       .setMapEntryCount( spec_ent.size() )
@@ -193,8 +239,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.conv2_backward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -230,6 +275,11 @@ namespace liblnn {
       .setBuffer( output_grad.get() )
       .setOffset( output_grad.offset() * sizeof( float ) )
       .setRange( output_grad.size() * sizeof( float ) );
+    const auto &shortcut_grad_buffer = use_shortcut ? shortcut_grad : input_grad;
+    auto shortcut_grad_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( shortcut_grad_buffer.get() )
+      .setOffset( shortcut_grad_buffer.offset() * sizeof( float ) )
+      .setRange( shortcut_grad_buffer.size() * sizeof( float ) );
     device->updateDescriptorSets(
       std::vector< vk::WriteDescriptorSet >{
          vk::WriteDescriptorSet()
@@ -261,21 +311,66 @@ namespace liblnn {
            .setDstBinding( 4 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &output_grad_dbi )
+           .setPBufferInfo( &output_grad_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 11 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &shortcut_grad_dbi )
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
     return layer( layer_def()
       .set_input_value( input_value )
       .set_output_value( output_value )
       .set_weight( weight )
       .set_input_grad( input_grad )
       .set_output_grad( output_grad )
+      .set_shortcut( shortcut_grad )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size/props.subgroup_props.subgroupSize, 1, batch_size ) );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );;
+  }
+  layer create_conv2_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t input_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    uint32_t input_width,
+    uint32_t input_height,
+    tensor_layout layout
+  ) {
+    return create_conv2_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, input_grad, output_grad, buffer_view< float >(),
+      output_width, output_height, output_channels, batch_size,
+      filter_width, filter_height, input_channels,
+      filter_xstride, filter_ystride, filter_zstride,
+      input_xmargin, input_ymargin, input_width, input_height, layout
+    );
   }
 }
 
@@ -53,7 +53,8 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
@@ -92,7 +93,7 @@ namespace liblnn {
     const uint32_t input_data_size = input_width * input_height * channels;
     const uint32_t output_data_size = output_width * output_height * channels;
     const uint32_t weight_size = filter_width * filter_height * channels;
-    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    if( input_value.size() != input_data_size * batch_size && input_value.size() != ( input_data_size * batch_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
     if( weight.size() != weight_size ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
@@ -100,7 +101,7 @@ namespace liblnn {
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
 /*
   륰롼פΥϥХå˹碌
@@ -124,15 +125,19 @@ namespace liblnn {
 
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto size = input_width * input_height * channels;
-    auto aligned_size = ( size / props.subgroup_props.subgroupSize + ( ( size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 11 > spec_data{
-      props.subgroup_props.subgroupSize, 1,
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv2_straight_backward", { output_width, output_height, channels, filter_width, filter_height, uint32_t( channels_last ) }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    std::array< uint32_t, 12 > spec_data{
+      local_group_size, 1,
       output_width, output_height,
       filter_width, filter_height, channels,
       filter_xstride, filter_ystride,
-      input_xmargin, input_ymargin
+      input_xmargin, input_ymargin,
+      channels_last
     };
-    std::array< vk::SpecializationMapEntry, 11 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 12 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -176,6 +181,10 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 11 )
         .setOffset( 40 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 12 )
+        .setOffset( 44 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -188,8 +197,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.conv2_straight_backward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -260,6 +268,7 @@ namespace liblnn {
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
     return layer( layer_def()
       .set_input_value( input_value )
       .set_output_value( output_value )
@@ -270,7 +279,8 @@ namespace liblnn {
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size/props.subgroup_props.subgroupSize, 1, batch_size ) );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );;
   }
 }
 
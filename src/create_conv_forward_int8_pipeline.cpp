@@ -0,0 +1,346 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <glm/vec4.hpp>
+#include <liblnn/layer_def.h>
+#include <liblnn/descriptor_set.h>
+#include <liblnn/pipeline_layout.h>
+#include <liblnn/exceptions.h>
+#include <liblnn/pipeline.h>
+
+namespace liblnn {
+  layer create_conv_forward_int8_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &quantized_weight,
+    const buffer_view< float > &weight_scale,
+    const buffer_view< glm::vec4 > &bias,
+    const buffer_view< float > &activation_range,
+    uint32_t slot,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t input_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    bool depthwise,
+    bool use_activation,
+    float slope,
+    uint32_t input_width,
+    uint32_t input_height,
+    tensor_layout layout
+  ) {
+    const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 0 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 1 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 16 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 17 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 18 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr )
+    };
+    if( depthwise && input_channels != output_channels ) throw invalid_data_length();
+    if( !input_width ) input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
+    if( !input_height ) input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
+    if( ( output_width - 1 ) * filter_xstride >= input_width + input_xmargin ) throw invalid_data_length();
+    if( ( output_height - 1 ) * filter_ystride >= input_height + input_ymargin ) throw invalid_data_length();
+    const uint32_t input_data_size = input_width * input_height * input_channels;
+    const uint32_t output_data_size = output_width * output_height * output_channels;
+    const uint32_t filter_size = filter_width * filter_height * ( depthwise ? 1 : input_channels );
+    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
+    if( quantized_weight.size() != output_channels * ( ( filter_size + 3 ) / 4 ) ) throw invalid_data_length();
+    if( weight_scale.size() != output_channels ) throw invalid_data_length();
+    if( slot >= activation_range.size() ) throw invalid_data_length();
+    const bool use_bias = bool( bias );
+    if( use_bias && bias.size() != output_channels ) throw invalid_data_length();
+    auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
+    std::vector< vk::PushConstantRange > push_constant_range{
+      vk::PushConstantRange()
+       .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+       .setOffset( 0 )
+       .setSize( 12 )
+    };
+    auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
+    auto size = output_width * output_height * output_channels;
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv_forward_int8", { output_width, output_height, output_channels, filter_width, filter_height, input_channels, input_width, input_height, uint32_t( depthwise ), uint32_t( channels_last ) }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    struct {
+      std::array< uint32_t, 14 > values;
+      float slope;
+      uint32_t input_width;
+      uint32_t input_height;
+      uint32_t channels_last;
+      uint32_t depthwise;
+      uint32_t slot;
+    } spec_data{
+      {
+        local_group_size, 1,
+        output_width, output_height, output_channels,
+        filter_width, filter_height, input_channels,
+        filter_xstride, filter_ystride,
+        input_xmargin, input_ymargin, use_bias, use_activation
+      },
+      slope,
+      input_width,
+      input_height,
+      channels_last,
+      depthwise,
+      slot
+    };
+    std::array< vk::SpecializationMapEntry, 20 > spec_ent{
+      vk::SpecializationMapEntry()
+        .setConstantID( 1 )
+        .setOffset( 0 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 2 )
+        .setOffset( 4 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 3 )
+        .setOffset( 8 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 4 )
+        .setOffset( 12 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 5 )
+        .setOffset( 16 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 6 )
+        .setOffset( 20 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 7 )
+        .setOffset( 24 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 8 )
+        .setOffset( 28 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 9 )
+        .setOffset( 32 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 10 )
+        .setOffset( 36 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 11 )
+        .setOffset( 40 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 12 )
+        .setOffset( 44 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 13 )
+        .setOffset( 48 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 14 )
+        .setOffset( 52 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 15 )
+        .setOffset( 56 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 16 )
+        .setOffset( 60 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 17 )
+        .setOffset( 64 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 18 )
+        .setOffset( 68 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 19 )
+        .setOffset( 72 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 20 )
+        .setOffset( 76 )
+        .setSize( 4 )
+    };
+    auto spec = vk::SpecializationInfo()
+      .setMapEntryCount( spec_ent.size() )
+      .setPMapEntries( spec_ent.data() )
+      .setDataSize( sizeof( spec_data ) )
+      .setPData( &spec_data );
+    auto pipelines = device->createComputePipelines(
+      *pipeline_cache,
+      std::vector< vk::ComputePipelineCreateInfo >{
+        vk::ComputePipelineCreateInfo()
+          .setStage(
+            get_shader_stage( props )
+              .setModule( *mods.conv_forward_int8 )
+              .setPName( "main" )
+              .setPSpecializationInfo( &spec )
+          )
+          .setLayout( *pipeline_layout )
+      }
+    );
+    std::shared_ptr< vk::Pipeline > pipeline(
+      new vk::Pipeline( std::move( pipelines[ 0 ] ) ),
+      [device,pipeline_cache,module=mods.conv_forward_int8,pipeline_layout]( vk::Pipeline *p ) {
+        if( p ) device->destroyPipeline( *p );
+        delete p;
+      }
+    );
+
+    auto input_value_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( input_value.get() )
+      .setOffset( input_value.offset() * sizeof( float ) )
+      .setRange( input_value.size() * sizeof( float ) );
+    auto output_value_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( output_value.get() )
+      .setOffset( output_value.offset() * sizeof( float ) )
+      .setRange( output_value.size() * sizeof( float ) );
+    auto quantized_weight_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( quantized_weight.get() )
+      .setOffset( quantized_weight.offset() * sizeof( float ) )
+      .setRange( quantized_weight.size() * sizeof( float ) );
+    auto weight_scale_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( weight_scale.get() )
+      .setOffset( weight_scale.offset() * sizeof( float ) )
+      .setRange( weight_scale.size() * sizeof( float ) );
+    auto activation_range_dbi = vk::DescriptorBufferInfo()
+      .setBuffer( activation_range.get() )
+      .setOffset( activation_range.offset() * sizeof( float ) )
+      .setRange( activation_range.size() * sizeof( float ) );
+    auto bias_dbi = use_bias ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias.get() )
+        .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+        .setRange( bias.size() * sizeof( glm::vec4 ) ) :
+      weight_scale_dbi;
+    device->updateDescriptorSets(
+      std::vector< vk::WriteDescriptorSet >{
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 0 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &input_value_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 1 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &output_value_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 16 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &quantized_weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 17 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &weight_scale_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 18 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &activation_range_dbi )
+      },
+      nullptr
+    );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
+    return layer( layer_def()
+      .set_input_value( input_value )
+      .set_output_value( output_value )
+      .set_bias( bias )
+      .set_quantized_weight( quantized_weight )
+      .set_weight_scale( weight_scale )
+      .set_activation_range( activation_range )
+      .set_descriptor_set( descriptor_set )
+      .set_pipeline( pipeline )
+      .set_descriptor_set_layout( descriptor_set_layout )
+      .set_pipeline_layout( pipeline_layout )
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );
+  }
+}
+
@@ -42,6 +42,7 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< glm::vec4 > &bias,
     uint32_t output_width,
     uint32_t output_height,
     uint32_t output_channels,
@@ -53,8 +54,24 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    bool use_activation,
+    float slope,
+    uint32_t input_width,
+    uint32_t input_height,
+    tensor_layout layout
   ) {
+    if(
+      filter_width == 1 && filter_height == 1 && filter_xstride == 1 && filter_ystride == 1 && input_xmargin == 0 && input_ymargin == 0 &&
+      ( !input_width || input_width == output_width ) && ( !input_height || input_height == output_height ) &&
+      input_value.size() == output_width * output_height * input_channels * batch_size
+    )
+      return create_pointwise_forward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input_value, output_value, weight, bias,
+        output_width * output_height, output_channels, batch_size, input_channels,
+        use_activation, slope, layout
+      );
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
         .setDescriptorType( vk::DescriptorType::eStorageBuffer )
@@ -73,35 +90,66 @@ namespace liblnn {
         .setDescriptorCount( 1 )
         .setBinding( 2 )
         .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 7 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
         .setPImmutableSamplers( nullptr )
     };
-    const uint32_t input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
-    const uint32_t input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
+    if( !input_width ) input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
+    if( !input_height ) input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
+    if( ( output_width - 1 ) * filter_xstride >= input_width + input_xmargin ) throw invalid_data_length();
+    if( ( output_height - 1 ) * filter_ystride >= input_height + input_ymargin ) throw invalid_data_length();
     const uint32_t input_data_size = input_width * input_height * input_channels;
     const uint32_t output_data_size = output_width * output_height * output_channels;
     const uint32_t weight_size = filter_width * filter_height * input_channels * output_channels;
-    std::cout << "conv input: " << input_width << "x" << input_height << "x" << input_channels << " output: " << output_width << "x" << output_height << "x" << output_channels << std::endl;
-    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    const bool bf16_input = input_value.size() != input_data_size * batch_size;
+    if( bf16_input && input_value.size() != ( input_data_size * batch_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
     if( weight.size() != weight_size ) throw invalid_data_length();
+    const bool use_bias = bool( bias );
+    if( use_bias && bias.size() != output_channels ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto size = output_width * output_height * output_channels;
-    auto aligned_size = ( size / props.subgroup_props.subgroupSize + ( ( size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 13 > spec_data{
-      props.subgroup_props.subgroupSize, 1,
-      output_width, output_height, output_channels,
-      filter_width, filter_height, input_channels,
-      filter_xstride, filter_ystride, filter_zstride,
-      input_xmargin, input_ymargin
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv_forward", { output_width, output_height, output_channels, filter_width, filter_height, input_channels, input_width, input_height, uint32_t( channels_last ), uint32_t( bf16_input ) }, props.subgroup_props.subgroupSize, size, { 1u, 2u, 4u } );
+    const uint32_t local_group_size = tuning.local_size;
+    const uint32_t outputs_per_thread = tuning.tile;
+    const uint32_t thread_count = size / outputs_per_thread + ( ( size % outputs_per_thread ) ? 1 : 0 );
+    auto aligned_size = ( thread_count / local_group_size + ( ( thread_count % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    struct {
+      std::array< uint32_t, 15 > values;
+      float slope;
+      uint32_t input_width;
+      uint32_t input_height;
+      uint32_t channels_last;
+      uint32_t bf16_input;
+      uint32_t outputs_per_thread;
+    } spec_data{
+      {
+        local_group_size, 1,
+        output_width, output_height, output_channels,
+        filter_width, filter_height, input_channels,
+        filter_xstride, filter_ystride, filter_zstride,
+        input_xmargin, input_ymargin, use_bias, use_activation
+      },
+      slope,
+      input_width,
+      input_height,
+      channels_last,
+      bf16_input,
+      outputs_per_thread
     };
-    std::array< vk::SpecializationMapEntry, 13 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 21 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -153,20 +201,51 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 13 )
         .setOffset( 48 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 14 )
+        .setOffset( 52 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 15 )
+        .setOffset( 56 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 16 )
+        .setOffset( 60 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 17 )
+        .setOffset( 64 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 18 )
+        .setOffset( 68 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 19 )
+        .setOffset( 72 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 20 )
+        .setOffset( 76 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 21 )
+        .setOffset( 80 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
       .setMapEntryCount( spec_ent.size() )
       .setPMapEntries( spec_ent.data() )
-      .setDataSize( spec_data.size() * sizeof( uint32_t ) )
-      .setPData( spec_data.data() );
+      .setDataSize( sizeof( spec_data ) )
+      .setPData( &spec_data );
     auto pipelines = device->createComputePipelines(
       *pipeline_cache,
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.conv_forward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -194,6 +273,12 @@ namespace liblnn {
       .setBuffer( weight.get() )
       .setOffset( weight.offset() * sizeof( glm::vec4 ) )
       .setRange( weight.size() * sizeof( glm::vec4 ) );
+    auto bias_dbi = use_bias ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( bias.get() )
+        .setOffset( bias.offset() * sizeof( glm::vec4 ) )
+        .setRange( bias.size() * sizeof( glm::vec4 ) ) :
+      weight_dbi;
     device->updateDescriptorSets(
       std::vector< vk::WriteDescriptorSet >{
          vk::WriteDescriptorSet()
@@ -213,19 +298,60 @@ namespace liblnn {
            .setDstBinding( 2 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &weight_dbi )
+           .setPBufferInfo( &weight_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 7 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &bias_dbi )
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
     return layer( layer_def()
       .set_input_value( input_value )
       .set_output_value( output_value )
       .set_weight( weight )
+      .set_bias( bias )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size / props.subgroup_props.subgroupSize, 1, batch_size ) );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );;
+  }
+  layer create_conv_forward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t output_channels,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t input_channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    tensor_layout layout
+  ) {
+    return create_conv_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, buffer_view< glm::vec4 >(),
+      output_width, output_height, output_channels, batch_size,
+      filter_width, filter_height, input_channels,
+      filter_xstride, filter_ystride, filter_zstride,
+      input_xmargin, input_ymargin, false, 0.01f, 0u, 0u, layout
+    );
   }
 }
 
@@ -42,6 +42,7 @@ namespace liblnn {
     const buffer_view< float > &input_value,
     const buffer_view< float > &output_value,
     const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &weight_grad,
     const buffer_view< float > &output_grad,
     uint32_t output_width,
     uint32_t output_height,
@@ -53,7 +54,8 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
@@ -79,14 +81,24 @@ namespace liblnn {
         .setDescriptorCount( 1 )
         .setBinding( 4 )
         .setStageFlags( vk::ShaderStageFlagBits::eCompute )
+        .setPImmutableSamplers( nullptr ),
+      vk::DescriptorSetLayoutBinding()
+        .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+        .setDescriptorCount( 1 )
+        .setBinding( 6 )
+        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
         .setPImmutableSamplers( nullptr )
     };
+    const bool deferred_update = bool( weight_grad );
+    const bool bf16_grad = deferred_update && weight_grad.size() != weight.size();
+    if( bf16_grad && weight_grad.size() != ( weight.size() + 1 ) / 2 ) throw invalid_data_length();
     const uint32_t input_width = ( output_width - 1 ) * filter_xstride + filter_width - input_xmargin * 2;
     const uint32_t input_height = ( output_height - 1 ) * filter_ystride + filter_height - input_ymargin * 2;
     const uint32_t input_data_size = input_width * input_height * channels;
     const uint32_t output_data_size = output_width * output_height * channels;
     const uint32_t weight_size = filter_width * filter_height * channels;
-    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    const bool bf16_input = input_value.size() != input_data_size * batch_size;
+    if( bf16_input && input_value.size() != ( input_data_size * batch_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
     if( weight.size() != weight_size ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
@@ -94,19 +106,27 @@ namespace liblnn {
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
-    auto aligned_size = ( weight_size / props.subgroup_props.subgroupSize + ( ( weight_size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 13 > spec_data{
-      props.subgroup_props.subgroupSize, 1,
+    const uint32_t invocation_count = bf16_grad ? ( weight_size + 1 ) / 2 : weight_size;
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv_straight_backward", { output_width, output_height, channels, batch_size, filter_width, filter_height, filter_xstride, filter_ystride, uint32_t( deferred_update ), uint32_t( bf16_grad ), uint32_t( bf16_input ), uint32_t( channels_last ) }, props.subgroup_props.subgroupSize, invocation_count );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( invocation_count / local_group_size + ( ( invocation_count % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    std::array< uint32_t, 16 > spec_data{
+      local_group_size, 1,
       batch_size,
       output_width, output_height,
       filter_width, filter_height, channels,
       filter_xstride, filter_ystride,
-      input_xmargin, input_ymargin
+      input_xmargin, input_ymargin,
+      deferred_update,
+      channels_last,
+      bf16_grad,
+      bf16_input
     };
-    std::array< vk::SpecializationMapEntry, 12 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 16 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -154,6 +174,22 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 12 )
         .setOffset( 44 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 13 )
+        .setOffset( 48 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 14 )
+        .setOffset( 52 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 15 )
+        .setOffset( 56 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 16 )
+        .setOffset( 60 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -166,8 +202,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.conv_straight_backward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -199,6 +234,12 @@ namespace liblnn {
       .setBuffer( output_grad.get() )
       .setOffset( output_grad.offset() * sizeof( float ) )
       .setRange( output_grad.size() * sizeof( float ) );
+    auto weight_grad_dbi = deferred_update ?
+      vk::DescriptorBufferInfo()
+        .setBuffer( weight_grad.get() )
+        .setOffset( weight_grad.offset() * sizeof( float ) )
+        .setRange( weight_grad.size() * sizeof( float ) ) :
+      output_grad_dbi;
     device->updateDescriptorSets(
       std::vector< vk::WriteDescriptorSet >{
          vk::WriteDescriptorSet()
@@ -224,7 +265,13 @@ namespace liblnn {
            .setDstBinding( 4 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &output_grad_dbi )
+           .setPBufferInfo( &output_grad_dbi ),
+         vk::WriteDescriptorSet()
+           .setDstSet( *descriptor_set )
+           .setDstBinding( 6 )
+           .setDescriptorType( vk::DescriptorType::eStorageBuffer )
+           .setDescriptorCount( 1 )
+           .setPBufferInfo( &weight_grad_dbi )
       },
       nullptr
     );
@@ -233,11 +280,45 @@ namespace liblnn {
       .set_output_value( output_value )
       .set_weight( weight )
       .set_output_grad( output_grad )
+      .set_weight_grad( weight_grad )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size/props.subgroup_props.subgroupSize, 1, 1 ) );
+      .set_dispatch_size( aligned_size/local_group_size, 1, 1 )
+      .set_tuning( tuning ) );
+  }
+  layer create_conv_straight_backward_pipeline(
+    const std::shared_ptr< vk::Device > &device,
+    const modules &mods,
+    const std::shared_ptr< vk::DescriptorPool > &descriptor_pool,
+    const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
+    const device_props &props,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &output_value,
+    const buffer_view< glm::vec4 > &weight,
+    const buffer_view< float > &output_grad,
+    uint32_t output_width,
+    uint32_t output_height,
+    uint32_t batch_size,
+    uint32_t filter_width,
+    uint32_t filter_height,
+    uint32_t channels,
+    uint32_t filter_xstride,
+    uint32_t filter_ystride,
+    uint32_t filter_zstride,
+    uint32_t input_xmargin,
+    uint32_t input_ymargin,
+    tensor_layout layout
+  ) {
+    return create_conv_straight_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, weight, buffer_view< float >(), output_grad,
+      output_width, output_height, batch_size,
+      filter_width, filter_height, channels,
+      filter_xstride, filter_ystride, filter_zstride,
+      input_xmargin, input_ymargin, layout
+    );
   }
 }
 
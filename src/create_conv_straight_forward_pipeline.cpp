@@ -52,7 +52,8 @@ namespace liblnn {
     uint32_t filter_ystride,
     uint32_t filter_zstride,
     uint32_t input_xmargin,
-    uint32_t input_ymargin
+    uint32_t input_ymargin,
+    tensor_layout layout
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
@@ -79,8 +80,8 @@ namespace liblnn {
     const uint32_t input_data_size = input_width * input_height * channels;
     const uint32_t output_data_size = output_width * output_height * channels;
     const uint32_t weight_size = filter_width * filter_height * channels;
-    std::cout << "conv straight input: " << input_width << "x" << input_height << "x" << channels << " output: " << output_width << "x" << output_height << "x" << channels << std::endl;
-    if( input_value.size() != input_data_size * batch_size ) throw invalid_data_length();
+    const bool bf16_input = input_value.size() != input_data_size * batch_size;
+    if( bf16_input && input_value.size() != ( input_data_size * batch_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_data_size * batch_size ) throw invalid_data_length();
     if( weight.size() != weight_size ) throw invalid_data_length();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
@@ -88,19 +89,27 @@ namespace liblnn {
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto size = output_width * output_height * channels;
-    auto aligned_size = ( size / props.subgroup_props.subgroupSize + ( ( size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 12 > spec_data{
-      props.subgroup_props.subgroupSize, 1,
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "conv_straight_forward", { output_width, output_height, channels, filter_width, filter_height, uint32_t( channels_last ), uint32_t( bf16_input ) }, props.subgroup_props.subgroupSize, size, { 1u, 2u, 4u } );
+    const uint32_t local_group_size = tuning.local_size;
+    const uint32_t outputs_per_thread = tuning.tile;
+    const uint32_t thread_count = size / outputs_per_thread + ( ( size % outputs_per_thread ) ? 1 : 0 );
+    auto aligned_size = ( thread_count / local_group_size + ( ( thread_count % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    std::array< uint32_t, 15 > spec_data{
+      local_group_size, 1,
       output_width, output_height,
       filter_width, filter_height, channels,
       filter_xstride, filter_ystride, filter_zstride,
-      input_xmargin, input_ymargin
+      input_xmargin, input_ymargin,
+      channels_last,
+      bf16_input,
+      outputs_per_thread
     };
-    std::array< vk::SpecializationMapEntry, 12 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 15 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -148,6 +157,18 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 12 )
         .setOffset( 44 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 13 )
+        .setOffset( 48 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 14 )
+        .setOffset( 52 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 15 )
+        .setOffset( 56 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -160,8 +181,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.conv_straight_forward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -212,6 +232,7 @@ namespace liblnn {
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
     return layer( layer_def()
       .set_input_value( input_value )
       .set_output_value( output_value )
@@ -220,7 +241,8 @@ namespace liblnn {
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size / props.subgroup_props.subgroupSize, 1, batch_size ) );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );;
   }
 }
 
@@ -23,7 +23,6 @@ SOFTWARE.
 #include <array>
 #include <vector>
 #include <utility>
-#include <boost/math/common_factor_rt.hpp>
 #include <glm/vec4.hpp>
 #include <liblnn/layer_def.h>
 #include <liblnn/descriptor_set.h>
@@ -38,7 +37,10 @@ namespace liblnn {
     const std::shared_ptr< vk::PipelineCache > &pipeline_cache,
     const device_props &props,
     const buffer_view< glm::vec4 > &weight,
-    uint32_t input_size
+    uint32_t input_size,
+    init_type type,
+    uint64_t seed,
+    uint32_t stream
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
@@ -49,20 +51,18 @@ namespace liblnn {
         .setPImmutableSamplers( nullptr )
     };
     const uint32_t size = weight.size();
-    uint32_t width = ( size > props.props.limits.maxComputeWorkGroupCount[ 0 ] ) ? boost::math::gcd( size, props.props.limits.maxComputeWorkGroupCount[ 0 ] ) : size;
-    uint32_t local_group_size = boost::math::gcd( width, props.subgroup_props.subgroupSize );
-    uint32_t height = size / width;
-    if( height > props.props.limits.maxComputeWorkGroupCount[ 1 ] ) throw too_large_data();
+    const auto tuning = get_tuning_entry( props, "init", { size, input_size, uint32_t( type ) }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
-    std::array< uint32_t, 3 > spec_data{ local_group_size, 1, input_size };
-    std::array< vk::SpecializationMapEntry, 3 > spec_ent {
+    std::array< uint32_t, 8 > spec_data{ local_group_size, 1, input_size, uint32_t( type ), uint32_t( seed ), uint32_t( seed >> 32 ), stream, size };
+    std::array< vk::SpecializationMapEntry, 8 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -74,20 +74,39 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 3 )
         .setOffset( 8 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 4 )
+        .setOffset( 12 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 5 )
+        .setOffset( 16 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 6 )
+        .setOffset( 20 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 7 )
+        .setOffset( 24 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 8 )
+        .setOffset( 28 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
       .setMapEntryCount( spec_ent.size() )
       .setPMapEntries( spec_ent.data() )
-      .setDataSize( spec_data.size() )
+      .setDataSize( spec_data.size() * sizeof( uint32_t ) )
       .setPData( spec_data.data() );
     auto pipelines = device->createComputePipelines(
       *pipeline_cache,
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
     .setStage(
-      vk::PipelineShaderStageCreateInfo()
-        .setStage( vk::ShaderStageFlagBits::eCompute )
+      get_shader_stage( props )
         .setModule( *mods.init )
         .setPName( "main" )
     .setPSpecializationInfo( &spec )
@@ -118,13 +137,15 @@ namespace liblnn {
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) );
     return layer( layer_def()
       .set_weight( weight )
       .set_descriptor_set( descriptor_set )
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( width / local_group_size, height, 1 ) );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], 1 )
+      .set_tuning( tuning ) );
   }
 }
 
@@ -49,7 +49,8 @@ namespace liblnn {
     uint32_t filter_width,
     uint32_t filter_height,
     uint32_t filter_xstride,
-    uint32_t filter_ystride
+    uint32_t filter_ystride,
+    tensor_layout layout
   ) {
     const std::vector< vk::DescriptorSetLayoutBinding > descriptor_set_layout_bindings{
       vk::DescriptorSetLayoutBinding()
@@ -82,7 +83,8 @@ namespace liblnn {
     const size_t input_width = ( output_width - 1 ) * filter_xstride + filter_width;
     const size_t input_height = ( output_height - 1 ) * filter_ystride + filter_height;
     const size_t input_size = input_width * input_height * channels * batch_size;
-    if( input_value.size() != input_size ) throw invalid_data_length();
+    const bool bf16_input = input_value.size() != input_size;
+    if( bf16_input && input_value.size() != ( input_size + 1 ) / 2 ) throw invalid_data_length();
     if( output_value.size() != output_size ) throw invalid_data_length();
     if( input_grad.size() != input_size ) throw invalid_data_length();
     if( output_grad.size() != output_size ) throw invalid_data_length();
@@ -90,17 +92,21 @@ namespace liblnn {
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto size = output_width * output_height * channels;
-    auto aligned_size = ( size / props.subgroup_props.subgroupSize + ( ( size % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 9 > spec_data{
-      props.subgroup_props.subgroupSize, 1, output_width, output_height,
-      channels, filter_width, filter_height, filter_xstride, filter_ystride
+    const bool channels_last = layout == tensor_layout::nhwc;
+    const auto tuning = get_tuning_entry( props, "max_pooling_backward", { output_width, output_height, channels, filter_width, filter_height, uint32_t( channels_last ), uint32_t( bf16_input ) }, props.subgroup_props.subgroupSize, size );
+    const uint32_t local_group_size = tuning.local_size;
+    auto aligned_size = ( size / local_group_size + ( ( size % local_group_size ) ? 1 : 0 ) ) * local_group_size;
+    std::array< uint32_t, 11 > spec_data{
+      local_group_size, 1, output_width, output_height,
+      channels, filter_width, filter_height, filter_xstride, filter_ystride,
+      channels_last, bf16_input
     };
-    std::array< vk::SpecializationMapEntry, 9 > spec_ent {
+    std::array< vk::SpecializationMapEntry, 11 > spec_ent {
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -136,6 +142,14 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 9 )
         .setOffset( 32 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 10 )
+        .setOffset( 36 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 11 )
+        .setOffset( 40 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -148,8 +162,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.maxpooling_backward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -210,6 +223,7 @@ namespace liblnn {
       },
       nullptr
     );
+    const auto dispatch_size = get_dispatch_size( props, aligned_size / local_group_size );
     return layer( layer_def()
       .set_input_value( input_value )
       .set_output_value( output_value )
@@ -219,8 +233,8 @@ namespace liblnn {
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_size / props.subgroup_props.subgroupSize, 1, batch_size )
-    );
+      .set_dispatch_size( dispatch_size[ 0 ], dispatch_size[ 1 ], batch_size )
+      .set_tuning( tuning ) );
   }
 }
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #include <array>
 #include <vector>
 #include <utility>
+#include <algorithm>
 #include <boost/math/common_factor_rt.hpp>
 #include <glm/vec3.hpp>
 #include <liblnn/layer_def.h>
@@ -74,19 +75,21 @@ namespace liblnn {
     if( input_value.size() % batch_size ) throw invalid_data_length();
     if( input_value.size() != teacher_value.size() ) throw invalid_data_length();
     if( input_value.size() != input_grad.size() ) throw invalid_data_length();
-    if( width > props.props.limits.maxComputeWorkGroupSize[ 0 ] ) throw too_large_data();
-    if( batch_size > props.props.limits.maxComputeWorkGroupCount[ 2 ] ) throw too_large_data();
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     auto aligned_width = ( width / props.subgroup_props.subgroupSize + ( ( width % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    std::array< uint32_t, 4 > spec_data{ aligned_width, 1, width, aligned_width / props.subgroup_props.subgroupSize };
-    std::array< vk::SpecializationMapEntry, 4 > spec_ent{
+    uint32_t default_local_group_size = std::min( { aligned_width, props.props.limits.maxComputeWorkGroupSize[ 0 ], props.props.limits.maxComputeWorkGroupInvocations } );
+    default_local_group_size = std::max( default_local_group_size / props.subgroup_props.subgroupSize, uint32_t( 1 ) ) * props.subgroup_props.subgroupSize;
+    const auto tuning = get_tuning_entry( props, "softmax_combined", { width }, default_local_group_size, width );
+    const uint32_t local_group_size = tuning.local_size;
+    std::array< uint32_t, 5 > spec_data{ local_group_size, 1, width, local_group_size / props.subgroup_props.subgroupSize, get_subgroup_size( props ) };
+    std::array< vk::SpecializationMapEntry, 5 > spec_ent{
       vk::SpecializationMapEntry()
         .setConstantID( 1 )
         .setOffset( 0 )
@@ -102,6 +105,10 @@ namespace liblnn {
       vk::SpecializationMapEntry()
         .setConstantID( 4 )
         .setOffset( 12 )
+        .setSize( 4 ),
+      vk::SpecializationMapEntry()
+        .setConstantID( 5 )
+        .setOffset( 16 )
         .setSize( 4 )
     };
     auto spec = vk::SpecializationInfo()
@@ -114,8 +121,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props, spec_data[ 0 ] )
               .setModule( *mods.softmax_combined )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -172,7 +178,7 @@ namespace liblnn {
            .setDstBinding( 5 )
            .setDescriptorType( vk::DescriptorType::eStorageBuffer )
            .setDescriptorCount( 1 )
-           .setPBufferInfo( &teacher_value_dbi ),
+           .setPBufferInfo( &teacher_value_dbi )
       },
       nullptr
     );
@@ -185,7 +191,8 @@ namespace liblnn {
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( 1, 1, batch_size ) );
+      .set_dispatch_size( 1, 1, batch_size )
+      .set_tuning( tuning ) );
   }
 }
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #include <array>
 #include <vector>
 #include <utility>
+#include <algorithm>
 #include <boost/math/common_factor_rt.hpp>
 #include <glm/vec3.hpp>
 #include <liblnn/layer_def.h>
@@ -59,14 +60,15 @@ namespace liblnn {
     const uint32_t size = input_value.size();
     if( input_value.size() != output_value.size() ) throw invalid_data_length();
     uint32_t width = size;
-    auto aligned_width = ( width / props.subgroup_props.subgroupSize + ( ( width % props.subgroup_props.subgroupSize ) ? 1 : 0 ) ) * props.subgroup_props.subgroupSize;
-    uint32_t local_group_size = props.subgroup_props.subgroupSize;
+    const auto tuning = get_tuning_entry( props, "tanh_forward", { width }, props.subgroup_props.subgroupSize, width );
+    uint32_t local_group_size = tuning.local_size;
+    auto aligned_width = ( width / local_group_size + ( ( width % local_group_size ) ? 1 : 0 ) ) * local_group_size;
     auto [descriptor_set,descriptor_set_layout] = get_descriptor_set( device, descriptor_pool, descriptor_set_layout_bindings );
     std::vector< vk::PushConstantRange > push_constant_range{
       vk::PushConstantRange()
        .setStageFlags( vk::ShaderStageFlagBits::eCompute )
        .setOffset( 0 )
-       .setSize( 8 )
+       .setSize( 12 )
     };
     auto pipeline_layout = get_pipeline_layout( device, descriptor_set_layout, push_constant_range );
     uint32_t spec_data[] = { local_group_size, 1, width };
@@ -94,8 +96,7 @@ namespace liblnn {
       std::vector< vk::ComputePipelineCreateInfo >{
         vk::ComputePipelineCreateInfo()
           .setStage(
-            vk::PipelineShaderStageCreateInfo()
-              .setStage( vk::ShaderStageFlagBits::eCompute )
+            get_shader_stage( props )
               .setModule( *mods.tanh_forward )
               .setPName( "main" )
               .setPSpecializationInfo( &spec )
@@ -143,7 +144,8 @@ namespace liblnn {
       .set_pipeline( pipeline )
       .set_descriptor_set_layout( descriptor_set_layout )
       .set_pipeline_layout( pipeline_layout )
-      .set_dispatch_size( aligned_width / local_group_size, 1, 1 ) );
+      .set_dispatch_size( std::min( aligned_width / local_group_size, props.props.limits.maxComputeWorkGroupCount[ 0 ] ), 1, 1 )
+      .set_tuning( tuning ) );
   }
 }
 
@@ -22,10 +22,12 @@ SOFTWARE.
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <vector>
 #include <liblnn/config.h>
 #include <liblnn/device.h>
+#include <liblnn/device_props.h>
 #include <liblnn/exceptions.h>
 
 namespace liblnn {
@@ -49,12 +51,24 @@ namespace liblnn {
       vk::DeviceQueueCreateInfo()
         .setQueueFamilyIndex( queue_index ).setQueueCount( 1 ).setPQueuePriorities( &priority );
     const auto features = physical_device.getFeatures();
+    auto extensions = dext;
+    void *next = nullptr;
+    auto subgroup_size_control_features = vk::PhysicalDeviceSubgroupSizeControlFeaturesEXT();
+    if( is_subgroup_size_control_available( physical_device ) ) {
+      if( std::find_if( extensions.begin(), extensions.end(), []( const char *v ) { return !strcmp( v, VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME ); } ) == extensions.end() )
+        extensions.push_back( VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME );
+      subgroup_size_control_features
+        .setSubgroupSizeControl( true )
+        .setComputeFullSubgroups( true );
+      next = &subgroup_size_control_features;
+    }
     auto device = physical_device.createDevice(
       vk::DeviceCreateInfo()
+        .setPNext( next )
         .setQueueCreateInfoCount( 1 )
         .setPQueueCreateInfos( &queue_create_info )
-        .setEnabledExtensionCount( dext.size() )
-        .setPpEnabledExtensionNames( dext.data() )
+        .setEnabledExtensionCount( extensions.size() )
+        .setPpEnabledExtensionNames( extensions.data() )
         .setEnabledLayerCount( dlayers.size() )
         .setPpEnabledLayerNames( dlayers.data() )
         .setPEnabledFeatures( &features )
@@ -20,21 +20,59 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cstring>
+#include <algorithm>
 #include <liblnn/device_props.h>
 namespace liblnn {
+  bool is_subgroup_size_control_available(
+    const vk::PhysicalDevice &physical_device
+  ) {
+    const auto available = physical_device.enumerateDeviceExtensionProperties();
+    if( std::find_if( available.begin(), available.end(), []( const auto &v ) { return !strcmp( v.extensionName, VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME ); } ) == available.end() )
+      return false;
+    auto subgroup_size_control_features = vk::PhysicalDeviceSubgroupSizeControlFeaturesEXT();
+    auto features2 = vk::PhysicalDeviceFeatures2();
+    features2.pNext = &subgroup_size_control_features;
+    physical_device.getFeatures2( &features2 );
+    return subgroup_size_control_features.subgroupSizeControl && subgroup_size_control_features.computeFullSubgroups;
+  }
   device_props get_device_props(
     const vk::PhysicalDevice &physical_device
   ) {
+    const bool subgroup_size_control_available = is_subgroup_size_control_available( physical_device );
     auto subgroup_props = vk::PhysicalDeviceSubgroupProperties();
+    auto subgroup_size_control_props = vk::PhysicalDeviceSubgroupSizeControlPropertiesEXT();
     auto props2 = vk::PhysicalDeviceProperties2();
     props2.pNext = &subgroup_props;
+    if( subgroup_size_control_available )
+      subgroup_props.pNext = &subgroup_size_control_props;
     physical_device.getProperties2( &props2 );
+    subgroup_props.pNext = nullptr;
     auto props = vk::PhysicalDeviceProperties();
     physical_device.getProperties( &props );
+    auto subgroup_size_control_features = vk::PhysicalDeviceSubgroupSizeControlFeaturesEXT();
+    if( subgroup_size_control_available ) {
+      auto features2 = vk::PhysicalDeviceFeatures2();
+      features2.pNext = &subgroup_size_control_features;
+      physical_device.getFeatures2( &features2 );
+      subgroup_size_control_features.pNext = nullptr;
+    }
+    const bool subgroup_size_control =
+      subgroup_size_control_available &&
+      bool( subgroup_size_control_props.requiredSubgroupSizeStages & vk::ShaderStageFlagBits::eCompute ) &&
+      subgroup_props.subgroupSize >= subgroup_size_control_props.minSubgroupSize &&
+      subgroup_props.subgroupSize <= subgroup_size_control_props.maxSubgroupSize;
     return device_props()
       .set_props( props )
       .set_props2( props2 )
-      .set_subgroup_props( subgroup_props );
+      .set_subgroup_props( subgroup_props )
+      .set_subgroup_size_control_props( subgroup_size_control_props )
+      .set_subgroup_size_control_features( subgroup_size_control_features )
+      .set_required_subgroup_size(
+        vk::PipelineShaderStageRequiredSubgroupSizeCreateInfoEXT()
+          .setRequiredSubgroupSize( subgroup_props.subgroupSize )
+      )
+      .set_subgroup_size_control( subgroup_size_control );
   }
 }
 
@@ -0,0 +1,38 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <liblnn/pipeline.h>
+namespace liblnn {
+  uint32_t get_subgroup_size( const device_props &props ) {
+    return props.subgroup_size_control ? props.subgroup_props.subgroupSize : 0u;
+  }
+  vk::PipelineShaderStageCreateInfo get_shader_stage( const device_props &props, uint32_t local_size ) {
+    auto stage = vk::PipelineShaderStageCreateInfo()
+      .setStage( vk::ShaderStageFlagBits::eCompute );
+    if( !props.subgroup_size_control ) return stage;
+    stage.setPNext( &props.required_subgroup_size );
+    if( local_size && !( local_size % props.subgroup_props.subgroupSize ) )
+      stage.setFlags( vk::PipelineShaderStageCreateFlagBits::eRequireFullSubgroupsEXT );
+    return stage;
+  }
+}
+
@@ -33,8 +33,9 @@ namespace liblnn {
   input_cache::input_cache(
     std::shared_ptr< VmaAllocator > allocator,
     std::shared_ptr< data_source > source_,
-    uint32_t count
-  ) : source( source_ ), cache_count( count ), current_image( count ) {
+    uint32_t count,
+    tensor_layout layout_
+  ) : source( source_ ), cache_count( count ), current_image( count ), layout( layout_ ) {
     images.reset( new liblnn::buffer< float >(
       allocator, VMA_MEMORY_USAGE_CPU_TO_GPU,
       vk::BufferCreateInfo()
@@ -58,6 +59,18 @@ namespace liblnn {
   ) {
     if( current_image == cache_count ) {
       (*source)( command_buffer, device, queue, props, images, labels );
+      if( layout == tensor_layout::nhwc && get_image_channel() != 1 ) {
+        const size_t plane = get_image_width() * get_image_height();
+        const size_t channels = get_image_channel();
+        std::vector< float > image( plane * channels );
+        auto mapped = images->map();
+        for( size_t offset = 0u; offset != cache_count * plane * channels; offset += plane * channels ) {
+          std::copy( mapped.get() + offset, mapped.get() + offset + plane * channels, image.begin() );
+          for( size_t channel = 0u; channel != channels; ++channel )
+            for( size_t pixel = 0u; pixel != plane; ++pixel )
+              mapped.get()[ offset + channel + pixel * channels ] = image[ pixel + channel * plane ];
+        }
+      }
       current_image = 0;
     }
     size_t image_size = get_image_width() * get_image_height() * get_image_channel();
@@ -22,9 +22,12 @@ SOFTWARE.
 
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <glm/vec4.hpp>
 #include <liblnn/layer.h>
 namespace liblnn {
+  // minimum of maxComputeWorkGroupCount guaranteed by every Vulkan implementation
+  constexpr uint32_t max_group_count = 65535u;
   void layer::operator()( vk::CommandBuffer &command_buffer ) const {
     std::vector< uint32_t > ds_offset{};
     command_buffer.bindDescriptorSets( vk::PipelineBindPoint::eCompute, *def.pipeline_layout, 0, *def.descriptor_set, ds_offset );
@@ -85,29 +88,123 @@ namespace liblnn {
           .setOffset( def.teacher_value.offset() * sizeof( float ) )
           .setSize( def.teacher_value.size() * sizeof( float ) )
       );
-    std::array< uint32_t, 1 > pcs{ def.batch_count };
-    if( def.clear_input_grad && def.input_grad ) {
-      std::vector< vk::BufferMemoryBarrier > fill_barrier;
-      fill_barrier.emplace_back(
+    if( def.weight_grad )
+      barrier.emplace_back(
         vk::BufferMemoryBarrier()
           .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
           .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
-          .setBuffer( def.input_grad.get() )
-          .setOffset( def.input_grad.offset() * sizeof( float ) )
-          .setSize( def.input_grad.size() * sizeof( float ) )
+          .setBuffer( def.weight_grad.get() )
+          .setOffset( def.weight_grad.offset() * sizeof( float ) )
+          .setSize( def.weight_grad.size() * sizeof( float ) )
+      );
+    if( def.bias )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.bias.get() )
+          .setOffset( def.bias.offset() * sizeof( glm::vec4 ) )
+          .setSize( def.bias.size() * sizeof( glm::vec4 ) )
+      );
+    if( def.mask )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.mask.get() )
+          .setOffset( def.mask.offset() * sizeof( float ) )
+          .setSize( def.mask.size() * sizeof( float ) )
+      );
+    if( def.shortcut )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.shortcut.get() )
+          .setOffset( def.shortcut.offset() * sizeof( float ) )
+          .setSize( def.shortcut.size() * sizeof( float ) )
+      );
+    if( def.depthwise_weight )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.depthwise_weight.get() )
+          .setOffset( def.depthwise_weight.offset() * sizeof( glm::vec4 ) )
+          .setSize( def.depthwise_weight.size() * sizeof( glm::vec4 ) )
+      );
+    if( def.depthwise_value )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.depthwise_value.get() )
+          .setOffset( def.depthwise_value.offset() * sizeof( float ) )
+          .setSize( def.depthwise_value.size() * sizeof( float ) )
+      );
+    if( def.bias_grad )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.bias_grad.get() )
+          .setOffset( def.bias_grad.offset() * sizeof( float ) )
+          .setSize( def.bias_grad.size() * sizeof( float ) )
+      );
+    if( def.quantized_weight )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.quantized_weight.get() )
+          .setOffset( def.quantized_weight.offset() * sizeof( float ) )
+          .setSize( def.quantized_weight.size() * sizeof( float ) )
+      );
+    if( def.weight_scale )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.weight_scale.get() )
+          .setOffset( def.weight_scale.offset() * sizeof( float ) )
+          .setSize( def.weight_scale.size() * sizeof( float ) )
+      );
+    if( def.activation_range )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.activation_range.get() )
+          .setOffset( def.activation_range.offset() * sizeof( float ) )
+          .setSize( def.activation_range.size() * sizeof( float ) )
+      );
+    if( def.output_weight )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.output_weight.get() )
+          .setOffset( def.output_weight.offset() * sizeof( glm::vec4 ) )
+          .setSize( def.output_weight.size() * sizeof( glm::vec4 ) )
+      );
+    if( def.scratch )
+      barrier.emplace_back(
+        vk::BufferMemoryBarrier()
+          .setSrcAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setDstAccessMask( vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite )
+          .setBuffer( def.scratch.get() )
+          .setOffset( def.scratch.offset() * sizeof( float ) )
+          .setSize( def.scratch.size() * sizeof( float ) )
       );
-      command_buffer.fillBuffer( def.input_grad.get(), 0, def.input_grad.size() * sizeof( float ), 0 );
-      command_buffer.pipelineBarrier(
-        vk::PipelineStageFlagBits::eComputeShader,
-        vk::PipelineStageFlagBits::eComputeShader,
-        vk::DependencyFlagBits::eDeviceGroup,
-        std::vector< vk::MemoryBarrier >{},
-        fill_barrier,
-        std::vector< vk::ImageMemoryBarrier >{}
-      );
-    }
-    command_buffer.pushConstants< uint32_t >( *def.pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, pcs );
-    command_buffer.dispatch( def.dispatch_size[ 0 ], def.dispatch_size[ 1 ], def.dispatch_size[ 2 ] );
+    const bool profiling = def.tuning.db && def.tuning.db->is_profiling();
+    const uint32_t query = profiling ? def.tuning.db->begin( command_buffer, def.tuning.key, tuning_parameters( def.tuning.local_size, def.tuning.tile ) ) : 0u;
+    for( uint32_t group_offset_y = 0u; group_offset_y < def.dispatch_size[ 1 ]; group_offset_y += max_group_count )
+      for( uint32_t batch_offset = 0u; batch_offset < def.dispatch_size[ 2 ]; batch_offset += max_group_count ) {
+        std::array< uint32_t, 3 > pcs{ def.batch_count, batch_offset, group_offset_y };
+        command_buffer.pushConstants< uint32_t >( *def.pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0, pcs );
+        command_buffer.dispatch( def.dispatch_size[ 0 ], std::min( def.dispatch_size[ 1 ] - group_offset_y, max_group_count ), std::min( def.dispatch_size[ 2 ] - batch_offset, max_group_count ) );
+      }
+    if( profiling ) def.tuning.db->end( command_buffer, query );
     command_buffer.pipelineBarrier(
       vk::PipelineStageFlagBits::eComputeShader,
       vk::PipelineStageFlagBits::eComputeShader,
@@ -75,7 +75,7 @@ namespace liblnn {
         boost::spirit::qi::parse( hbegin, hend, boost::spirit::qi::big_dword, image_width );
         boost::spirit::qi::parse( hbegin, hend, boost::spirit::qi::big_dword, image_height );
         image_head = hend;
-        if( file_size < ( 16 + image_count * image_width * image_height ) ) throw corrupted_file();
+        if( file_size < ( 16 + size_t( image_count ) * image_width * image_height ) ) throw corrupted_file();
       }
     }
     {
@@ -137,8 +137,8 @@ namespace liblnn {
       for( uint32_t local_image_index = 0; local_image_index != batch_size; ++local_image_index ) {
         selected_index.push_back( dist( gen ) );
         uint32_t global_image_index = selected_index.back(); // ( current_image + local_image_index ) % image_count;
-	auto ibegin = image_head + global_image_index * image_width * image_height;
-	auto iend = image_head + ( global_image_index + 1 ) * image_width * image_height;
+	auto ibegin = image_head + size_t( global_image_index ) * image_width * image_height;
+	auto iend = image_head + size_t( global_image_index + 1 ) * image_width * image_height;
         std::transform( ibegin, iend, obegin, []( unsigned char v ) { return v / 255.f; } );
 	obegin += image_width * image_height;
       }
@@ -158,7 +158,7 @@ namespace liblnn {
     current_image %= image_count;
   }
 
-  std::tuple< std::shared_ptr< buffer< float > >, uint32_t >
+  std::tuple< std::shared_ptr< buffer< float > >, uint32_t, uint32_t, uint32_t >
   load_mnist_images(
     const std::shared_ptr< VmaAllocator > &allocator,
     const std::string &filename
@@ -186,12 +186,16 @@ namespace liblnn {
       boost::spirit::qi::parse( hbegin, hend, boost::spirit::qi::big_dword, data_count );
       uint32_t width = 0;
       boost::spirit::qi::parse( hbegin, hend, boost::spirit::qi::big_dword, width );
-      if( width != 0x1c ) throw corrupted_file();
+      if( !width ) throw corrupted_file();
       uint32_t height = 0;
       boost::spirit::qi::parse( hbegin, hend, boost::spirit::qi::big_dword, height );
-      if( height != 0x1c ) throw corrupted_file();
+      if( !height ) throw corrupted_file();
+      if( file_size < ( 16 + size_t( data_count ) * width * height ) ) throw corrupted_file();
       auto dbegin = hend;
-      size_t output_size = 32 * 32 * data_count;
+      const uint32_t padded_width = width + 4;
+      const uint32_t padded_height = height + 4;
+      const size_t padded_size = size_t( padded_width ) * padded_height;
+      size_t output_size = padded_size * data_count;
       std::shared_ptr< liblnn::buffer< float > > output( new liblnn::buffer< float >( allocator, VMA_MEMORY_USAGE_CPU_TO_GPU,
         vk::BufferCreateInfo()
           .setSize( output_size * sizeof( float ) )
@@ -205,12 +209,12 @@ namespace liblnn {
 	for( uint32_t data_index = 0; data_index != data_count; ++data_index ) {
 	  for( uint32_t y = 0; y != height; ++y ) {
 	    for( uint32_t x = 0; x != width; ++x ) {
-	      obegin[ data_index * 32 * 32 + ( y + 2 ) * width + x + 2 ] = dbegin[ data_index * width * height + y * width + x ] / 255.f;
+	      obegin[ data_index * padded_size + ( y + 2 ) * padded_width + x + 2 ] = dbegin[ data_index * size_t( width ) * height + y * width + x ] / 255.f;
 	    }
 	  }
 	}
       }
-      return std::make_tuple( output, data_count ); 
+      return std::make_tuple( output, data_count, padded_width, padded_height );
     }
   }
   std::tuple< std::shared_ptr< buffer< float > >, uint32_t >
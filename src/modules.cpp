@@ -42,5 +42,30 @@ namespace liblnn {
     maxpooling_forward = liblnn::get_shader( device, "maxpooling_forward.comp.spv" );
     maxpooling_backward = liblnn::get_shader( device, "maxpooling_backward.comp.spv" );
     softmax_combined = liblnn::get_shader( device, "softmax_combined.comp.spv" );
+    grad_norm = liblnn::get_shader( device, "grad_norm.comp.spv" );
+    clipped_update = liblnn::get_shader( device, "clipped_update.comp.spv" );
+    batchnorm_forward = liblnn::get_shader( device, "batchnorm_forward.comp.spv" );
+    batchnorm_backward = liblnn::get_shader( device, "batchnorm_backward.comp.spv" );
+    batchnorm_fold = liblnn::get_shader( device, "batchnorm_fold.comp.spv" );
+    dropout_forward = liblnn::get_shader( device, "dropout_forward.comp.spv" );
+    dropout_backward = liblnn::get_shader( device, "dropout_backward.comp.spv" );
+    add_forward = liblnn::get_shader( device, "add_forward.comp.spv" );
+    leaky_relu_forward = liblnn::get_shader( device, "leaky_relu_forward.comp.spv" );
+    leaky_relu_backward = liblnn::get_shader( device, "leaky_relu_backward.comp.spv" );
+    pointwise_forward = liblnn::get_shader( device, "pointwise_forward.comp.spv" );
+    pointwise_backward = liblnn::get_shader( device, "pointwise_backward.comp.spv" );
+    pointwise2_backward = liblnn::get_shader( device, "pointwise2_backward.comp.spv" );
+    separable_forward = liblnn::get_shader( device, "separable_forward.comp.spv" );
+    avgpooling_forward = liblnn::get_shader( device, "avgpooling_forward.comp.spv" );
+    avgpooling_backward = liblnn::get_shader( device, "avgpooling_backward.comp.spv" );
+    quantize_weight = liblnn::get_shader( device, "quantize_weight.comp.spv" );
+    activation_range = liblnn::get_shader( device, "activation_range.comp.spv" );
+    affine_forward_int8 = liblnn::get_shader( device, "affine_forward_int8.comp.spv" );
+    conv_forward_int8 = liblnn::get_shader( device, "conv_forward_int8.comp.spv" );
+    mlp_step = liblnn::get_shader( device, "mlp_step.comp.spv" );
+    relu_mask_forward = liblnn::get_shader( device, "relu_mask_forward.comp.spv" );
+    relu_mask_backward = liblnn::get_shader( device, "relu_mask_backward.comp.spv" );
+    conv_block_forward = liblnn::get_shader( device, "conv_block_forward.comp.spv" );
+    maxpooling_relu_backward = liblnn::get_shader( device, "maxpooling_relu_backward.comp.spv" );
   }
 }
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <chrono>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -53,7 +54,7 @@ namespace liblnn {
     const liblnn::modules &mods_,
     size_t batch_size_,
     bool debug_
-  ) : command_pool( command_pool_ ), device( device_ ), queue( queue_ ), descriptor_pool( descriptor_pool_ ), pipeline_cache( pipeline_cache_ ), props( props_ ), allocator( allocator_ ), train_input( tin_ ), eval_input( ein_ ), mods( mods_ ), batch_size( batch_size_ ), debug( debug_ ), swap_index( 0 ) {
+  ) : command_pool( command_pool_ ), device( device_ ), queue( queue_ ), descriptor_pool( descriptor_pool_ ), pipeline_cache( pipeline_cache_ ), props( props_ ), allocator( allocator_ ), train_input( tin_ ), eval_input( ein_ ), mods( mods_ ), batch_size( batch_size_ ), debug( debug_ ), swap_index( 0 ), max_grad_norm( 0.f ) {
     if( train_input->get_image_width() != eval_input->get_image_width() ) throw invalid_data_length();
     if( train_input->get_image_height() != eval_input->get_image_height() ) throw invalid_data_length();
     if( train_input->get_image_channel() != eval_input->get_image_channel() ) throw invalid_data_length();
@@ -61,7 +62,7 @@ namespace liblnn {
     const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
     const unsigned int image_size = train_input->get_image_width() * train_input->get_image_height() * train_input->get_image_channel();
     const unsigned int label_size = train_input->get_label_width();
-    command_buffers = liblnn::get_command_buffers( device, command_pool, 5 );
+    command_buffers = liblnn::get_command_buffers( device, command_pool, 6 );
     batch_images[ 0 ].reset( new liblnn::buffer< float >( allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( image_size * batch_size * sizeof( float ) )
@@ -105,7 +106,7 @@ namespace liblnn {
       std::shared_ptr< liblnn::buffer< glm::vec4 > > temp( new liblnn::buffer< glm::vec4 >(
         allocator, VMA_MEMORY_USAGE_GPU_TO_CPU,
         vk::BufferCreateInfo()
-          .setSize( weight.first->size() * sizeof( glm::vec4 ) )
+          .setSize( std::get< 0 >( weight )->size() * sizeof( glm::vec4 ) )
           .setUsage( vk::BufferUsageFlagBits::eTransferDst )
       ) );
       temporary_buffers.emplace_back( std::move( temp ) );
@@ -113,13 +114,13 @@ namespace liblnn {
     std::vector< std::array< vk::BufferCopy, 1 > > regions;
     for( const auto &weight: weights ) {
       regions.emplace_back( std::array< vk::BufferCopy, 1 >{
-        vk::BufferCopy().setSize( weight.first->size() * sizeof( glm::vec4 ) )
+        vk::BufferCopy().setSize( std::get< 0 >( weight )->size() * sizeof( glm::vec4 ) )
       } );
     }
     command_buffer.reset( vk::CommandBufferResetFlagBits::eReleaseResources );
     command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
     for( size_t index = 0u; index != weights.size(); ++index ) {
-      command_buffer.copyBuffer( weights[ index ].first->get(), temporary_buffers[ index ]->get(), regions[ index ] );
+      command_buffer.copyBuffer( std::get< 0 >( weights[ index ] )->get(), temporary_buffers[ index ]->get(), regions[ index ] );
     }
     command_buffer.end();
     queue->submit(
@@ -156,7 +157,7 @@ namespace liblnn {
       std::shared_ptr< liblnn::buffer< glm::vec4 > > temp( new liblnn::buffer< glm::vec4 >(
         allocator, VMA_MEMORY_USAGE_CPU_TO_GPU,
         vk::BufferCreateInfo()
-          .setSize( weight.first->size() * sizeof( glm::vec4 ) )
+          .setSize( std::get< 0 >( weight )->size() * sizeof( glm::vec4 ) )
           .setUsage( vk::BufferUsageFlagBits::eTransferSrc )
       ) );
       temporary_buffers.emplace_back( std::move( temp ) );
@@ -184,14 +185,16 @@ namespace liblnn {
     std::vector< std::array< vk::BufferCopy, 1 > > regions;
     for( const auto &weight: weights ) {
       regions.emplace_back( std::array< vk::BufferCopy, 1 >{
-        vk::BufferCopy().setSize( weight.first->size() * sizeof( glm::vec4 ) )
+        vk::BufferCopy().setSize( std::get< 0 >( weight )->size() * sizeof( glm::vec4 ) )
       } );
     }
     command_buffer.reset( vk::CommandBufferResetFlagBits::eReleaseResources );
     command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
     for( size_t index = 0u; index != weights.size(); ++index ) {
-      command_buffer.copyBuffer( temporary_buffers[ index ]->get(), weights[ index ].first->get(), regions[ index ] );
+      command_buffer.copyBuffer( temporary_buffers[ index ]->get(), std::get< 0 >( weights[ index ] )->get(), regions[ index ] );
     }
+    for( const auto &mask: masks )
+      command_buffer.fillBuffer( mask->get(), 0, mask->size() * sizeof( float ), 0 );
     command_buffer.end();
     queue->submit(
       vk::SubmitInfo()
@@ -201,17 +204,20 @@ namespace liblnn {
     );
     queue->waitIdle();
   }
-  void network::init() {
+  void network::init( uint64_t seed ) {
     auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
     auto &command_buffer = (*command_buffers)[ 0 ];
     std::vector< std::shared_ptr< layer > > layers;
-    for( const auto &weight: weights ) {
+    for( uint32_t index = 0u; index != weights.size(); ++index ) {
       layers.emplace_back( new layer( create_init_pipeline(
-        device, mods, descriptor_pool, pipeline_cache, props, weight.first, weight.second
+        device, mods, descriptor_pool, pipeline_cache, props, std::get< 0 >( weights[ index ] ), std::get< 1 >( weights[ index ] ),
+        std::get< 2 >( weights[ index ] ), seed, index
       ) ) );
     }
     command_buffer.reset( vk::CommandBufferResetFlagBits::eReleaseResources );
     command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+    for( const auto &mask: masks )
+      command_buffer.fillBuffer( mask->get(), 0, mask->size() * sizeof( float ), 0 );
     for( const auto &layer: layers )
       (*layer)( command_buffer );
     command_buffer.end();
@@ -224,6 +230,404 @@ namespace liblnn {
     );
     queue->waitIdle();
   }
+  buffer_view< float > network::deferred_grad( const std::shared_ptr< liblnn::buffer< glm::vec4 > > &weight, float alpha, bool bf16 ) {
+    if( max_grad_norm <= 0.f ) return buffer_view< float >();
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    std::shared_ptr< liblnn::buffer< float > > grad( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( ( bf16 ? ( weight->size() + 1 ) / 2 : weight->size() ) * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+    ) );
+    weight_grads.emplace_back( weight, grad, alpha );
+    return grad;
+  }
+  buffer_view< float > network::dropout_mask( size_t size ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    std::shared_ptr< liblnn::buffer< float > > mask( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( ( ( size + 31 ) / 32 + 1 ) * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
+    ) );
+    masks.emplace_back( mask );
+    return mask;
+  }
+  buffer_view< float > network::relu_mask( size_t size ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    std::shared_ptr< liblnn::buffer< float > > mask( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( ( size + 31 ) / 32 * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferDst )
+    ) );
+    masks.emplace_back( mask );
+    return mask;
+  }
+  block_layers network::build_residual_block(
+    const std::string &name,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &input_grad,
+    uint32_t width,
+    uint32_t height,
+    uint32_t channels,
+    float alpha,
+    tensor_layout layout,
+    bool bf16
+  ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    const size_t size = width * height * channels * batch_size;
+    if( input_value.size() != size ) throw invalid_data_length();
+    if( input_grad.size() != size ) throw invalid_data_length();
+    auto create_buffer = [&]( const std::string &suffix, bool packed = false ) {
+      std::shared_ptr< liblnn::buffer< float > > buf( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( ( packed ? ( size + 1 ) / 2 : size ) * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( name + suffix, buf ) );
+      return buf;
+    };
+    auto create_weight = [&]( size_t weight_size, uint32_t fan_in ) {
+      std::shared_ptr< liblnn::buffer< glm::vec4 > > weight( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( weight_size * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( weight, fan_in, init_type::he );
+      return weight;
+    };
+    const auto conv1_weight = create_weight( 3 * 3 * channels * channels, 3 * 3 * channels );
+    const auto conv2_weight = create_weight( 3 * 3 * channels * channels, 3 * 3 * channels );
+    const auto conv1_output = create_buffer( "_conv1_output" );
+    const auto activation1_output = create_buffer( "_activation1_output", bf16 );
+    const auto conv2_output = create_buffer( "_conv2_output" );
+    const auto add_output = create_buffer( "_add_output" );
+    const auto activation1_grad = create_buffer( "_activation1_grad" );
+    const auto conv2_grad = create_buffer( "_conv2_grad" );
+    const auto add_grad = create_buffer( "_add_grad" );
+    block_layers block;
+    block.output = create_buffer( "_output" );
+    block.output_grad = create_buffer( "_output_grad" );
+    const auto conv1_weight_grad = deferred_grad( conv1_weight, alpha, bf16 );
+    const auto conv2_weight_grad = deferred_grad( conv2_weight, alpha, bf16 );
+    block.forward.emplace_back( new layer( create_conv_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, conv1_output, conv1_weight,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, layout
+    ) ) );
+    block.forward.emplace_back( new layer( create_relu_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props, conv1_output, activation1_output
+    ) ) );
+    block.forward.emplace_back( new layer( create_conv_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      activation1_output, conv2_output, conv2_weight,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, layout
+    ) ) );
+    block.forward.emplace_back( new layer( create_add_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props, conv2_output, input_value, add_output
+    ) ) );
+    block.forward.emplace_back( new layer( create_relu_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props, add_output, block.output
+    ) ) );
+    block.backward.emplace_back( new layer( create_relu_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      add_output, block.output, add_grad, block.output_grad
+    ) ) );
+    block.backward.emplace_back( new layer( create_conv2_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      activation1_output, conv2_output, conv2_weight, conv2_grad, add_grad,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, 0u, 0u, layout
+    ) ) );
+    block.backward.emplace_back( new layer( create_conv_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      activation1_output, conv2_output, conv2_weight, conv2_weight_grad, add_grad,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, 0u, 0u, layout
+    ) ) );
+    block.backward.emplace_back( new layer( create_relu_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      conv1_output, activation1_output, activation1_grad, conv2_grad
+    ) ) );
+    block.backward.emplace_back( new layer( create_conv2_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, conv1_output, conv1_weight, input_grad, activation1_grad, add_grad,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, 0u, 0u, layout
+    ) ) );
+    block.backward.emplace_back( new layer( create_conv_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, conv1_output, conv1_weight, conv1_weight_grad, activation1_grad,
+      width, height, channels, batch_size, 3, 3, channels, 1, 1, 1, 1, 1, 0u, 0u, layout
+    ) ) );
+    return block;
+  }
+  block_layers network::build_separable_conv(
+    const std::string &name,
+    const buffer_view< float > &input_value,
+    const buffer_view< float > &input_grad,
+    const buffer_view< float > &output_value,
+    const buffer_view< float > &output_grad,
+    uint32_t width,
+    uint32_t height,
+    uint32_t input_channels,
+    uint32_t output_channels,
+    tensor_layout layout
+  ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    const size_t size = width * height * input_channels * batch_size;
+    if( input_value.size() != size ) throw invalid_data_length();
+    if( input_grad && input_grad.size() != size ) throw invalid_data_length();
+    auto create_weight = [&]( size_t weight_size, uint32_t fan_in ) {
+      std::shared_ptr< liblnn::buffer< glm::vec4 > > weight( new liblnn::buffer< glm::vec4 >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( weight_size * sizeof( glm::vec4 ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      weights.emplace_back( weight, fan_in, init_type::he );
+      return weight;
+    };
+    auto create_buffer = [&]( const std::string &suffix ) {
+      std::shared_ptr< liblnn::buffer< float > > buf( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      buffers.insert( std::make_pair( name + suffix, buf ) );
+      return buf;
+    };
+    const auto depthwise_weight = create_weight( 3 * 3 * input_channels, 3 * 3 );
+    const auto pointwise_weight = create_weight( input_channels * output_channels, input_channels );
+    const auto depthwise_output = create_buffer( "_depthwise_output" );
+    const auto depthwise_grad = create_buffer( "_depthwise_grad" );
+    const auto depthwise_weight_grad = deferred_grad( depthwise_weight, 0.001f );
+    const auto pointwise_weight_grad = deferred_grad( pointwise_weight, 0.0001f );
+    block_layers block;
+    block.output = output_value;
+    block.output_grad = output_grad;
+    block.forward.emplace_back( new layer( create_separable_forward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, output_value, depthwise_weight, pointwise_weight, depthwise_output,
+      width, height, input_channels, output_channels, batch_size, layout
+    ) ) );
+    block.backward.emplace_back( new layer( create_pointwise2_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      depthwise_output, output_value, pointwise_weight, depthwise_grad, output_grad,
+      width * height, output_channels, batch_size, input_channels, layout
+    ) ) );
+    block.backward.emplace_back( new layer( create_pointwise_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      depthwise_output, output_value, pointwise_weight, pointwise_weight_grad, output_grad,
+      width * height, output_channels, batch_size, input_channels, layout
+    ) ) );
+    if( input_grad )
+      block.backward.emplace_back( new layer( create_conv2_straight_backward_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props,
+        input_value, depthwise_output, depthwise_weight, input_grad, depthwise_grad,
+        width, height, batch_size, 3, 3, input_channels, 1, 1, 1, 1, 1, layout
+      ) ) );
+    block.backward.emplace_back( new layer( create_conv_straight_backward_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props,
+      input_value, depthwise_output, depthwise_weight, depthwise_weight_grad, depthwise_grad,
+      width, height, batch_size, 3, 3, input_channels, 1, 1, 1, 1, 1, layout
+    ) ) );
+    return block;
+  }
+  void network::build_clipping() {
+    if( weight_grads.empty() ) return;
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    grad_norm.reset( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( weight_grads.size() * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+    ) );
+    buffers.insert( std::make_pair( std::string( "grad_norm" ), grad_norm ) );
+    for( uint32_t slot = 0; slot != weight_grads.size(); ++slot ) {
+      clipping.emplace_back( new layer( create_grad_norm_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, std::get< 0 >( weight_grads[ slot ] ), std::get< 1 >( weight_grads[ slot ] ), grad_norm, slot
+      ) ) );
+    }
+    for( const auto &[weight,grad,alpha]: weight_grads ) {
+      clipping.emplace_back( new layer( create_clipped_update_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, weight, grad, grad_norm, max_grad_norm, alpha
+      ) ) );
+    }
+  }
+  std::pair< buffer_view< float >, buffer_view< float > > network::quantize_weight(
+    const std::shared_ptr< liblnn::buffer< glm::vec4 > > &weight,
+    uint32_t channels,
+    uint32_t channel_stride,
+    uint32_t element_stride,
+    uint32_t elements
+  ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    std::shared_ptr< liblnn::buffer< float > > quantized( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( channels * ( ( elements + 3 ) / 4 ) * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc )
+    ) );
+    std::shared_ptr< liblnn::buffer< float > > scale( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( channels * sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc )
+    ) );
+    quantization.emplace_back( new layer( create_quantize_weight_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props, weight, quantized, scale, channels, channel_stride, element_stride, elements
+    ) ) );
+    quantized_model.emplace_back( quantized );
+    quantized_model.emplace_back( scale );
+    return std::make_pair( buffer_view< float >( quantized ), buffer_view< float >( scale ) );
+  }
+  buffer_view< float > network::calibrate_range( const buffer_view< float > &value ) {
+    const auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
+    std::shared_ptr< liblnn::buffer< float > > range( new liblnn::buffer< float >(
+      allocator, buf_type,
+      vk::BufferCreateInfo()
+        .setSize( sizeof( float ) )
+        .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
+    ) );
+    calibration.emplace_back( new layer( create_activation_range_pipeline(
+      device, mods, descriptor_pool, pipeline_cache, props, value, range, 0
+    ) ) );
+    activation_ranges.emplace_back( range );
+    quantized_model.emplace_back( range );
+    return range;
+  }
+  void network::calibrate( size_t batches ) {
+    if( calibration.empty() ) throw invalid_data_length();
+    {
+      auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
+      auto &command_buffer = (*command_buffers)[ 0 ];
+      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+      for( const auto &range: activation_ranges )
+        command_buffer.fillBuffer( range->get(), 0, range->size() * sizeof( float ), 0 );
+      command_buffer.end();
+      queue->submit(
+        vk::SubmitInfo()
+          .setCommandBufferCount( 1 )
+          .setPCommandBuffers( &command_buffer ),
+        vk::Fence()
+      );
+      queue->waitIdle();
+    }
+    for( size_t i = 0; i != batches; ++i ) {
+      fill( true, true );
+      queue->submit(
+        vk::SubmitInfo()
+          .setCommandBufferCount( 1 )
+          .setPCommandBuffers( command_buffers->data() + 4 ),
+        vk::Fence()
+      );
+      queue->waitIdle();
+    }
+  }
+  void network::quantize() {
+    auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
+    auto &command_buffer = (*command_buffers)[ 0 ];
+    command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+    for( const auto &layer: quantization )
+      (*layer)( command_buffer );
+    command_buffer.end();
+    queue->submit(
+      vk::SubmitInfo()
+        .setCommandBufferCount( 1 )
+        .setPCommandBuffers( &command_buffer ),
+      vk::Fence()
+    );
+    queue->waitIdle();
+  }
+  void network::evaluate_quantized() {
+    float float_accuracy = 0.0;
+    float int8_accuracy = 0.0;
+    std::chrono::nanoseconds float_time( 0 );
+    std::chrono::nanoseconds int8_time( 0 );
+    for( size_t i = 0; i != 10; ++i ) {
+      fill( true, true );
+      queue->waitIdle();
+      for( size_t index: { 2, 5 } ) {
+        const auto begin = std::chrono::steady_clock::now();
+        queue->submit(
+          vk::SubmitInfo()
+            .setCommandBufferCount( 1 )
+            .setPCommandBuffers( command_buffers->data() + index ),
+          vk::Fence()
+        );
+        queue->waitIdle();
+        const auto elapsed = std::chrono::steady_clock::now() - begin;
+        const float accuracy = liblnn::evaluate( output_activation_output_eval, batch_labels[ 2 ], batch_size );
+        if( index == 2 ) {
+          float_accuracy += accuracy;
+          float_time += elapsed;
+        }
+        else {
+          int8_accuracy += accuracy;
+          int8_time += elapsed;
+        }
+      }
+    }
+    std::cout << "fp32: " << float_accuracy / 10.f << "\t" << std::chrono::duration_cast< std::chrono::microseconds >( float_time ).count() / 10 << "us/batch" << std::endl;
+    std::cout << "int8: " << int8_accuracy / 10.f << "\t" << std::chrono::duration_cast< std::chrono::microseconds >( int8_time ).count() / 10 << "us/batch" << std::endl;
+  }
+  void network::dump_quantized(
+    const std::string &filename
+  ) {
+    queue->waitIdle();
+    auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
+    auto &command_buffer = (*command_buffers)[ 0 ];
+    std::vector< std::shared_ptr< liblnn::buffer< float > > > temporary_buffers;
+    for( const auto &buf: quantized_model ) {
+      std::shared_ptr< liblnn::buffer< float > > temp( new liblnn::buffer< float >(
+        allocator, VMA_MEMORY_USAGE_GPU_TO_CPU,
+        vk::BufferCreateInfo()
+          .setSize( buf->size() * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eTransferDst )
+      ) );
+      temporary_buffers.emplace_back( std::move( temp ) );
+    }
+    std::vector< std::array< vk::BufferCopy, 1 > > regions;
+    for( const auto &buf: quantized_model ) {
+      regions.emplace_back( std::array< vk::BufferCopy, 1 >{
+        vk::BufferCopy().setSize( buf->size() * sizeof( float ) )
+      } );
+    }
+    command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+    for( size_t index = 0u; index != quantized_model.size(); ++index ) {
+      command_buffer.copyBuffer( quantized_model[ index ]->get(), temporary_buffers[ index ]->get(), regions[ index ] );
+    }
+    command_buffer.end();
+    queue->submit(
+      vk::SubmitInfo()
+        .setCommandBufferCount( 1 )
+        .setPCommandBuffers( &command_buffer ),
+      vk::Fence()
+    );
+    queue->waitIdle();
+    int fd = open( filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644 );
+    if( fd == -1 ) throw unable_to_load_file();
+    BOOST_SCOPE_EXIT( &fd ) {
+      close( fd );
+    } BOOST_SCOPE_EXIT_END
+    boost::crc_32_type crc32;
+    for( const auto &buf: temporary_buffers ) {
+      auto head = buf->map();
+      const long int length = buf->size() * sizeof( float );
+      auto result = write( fd, reinterpret_cast< void* >( head.get() ), length );
+      if( result != length ) throw unable_to_load_file();
+      crc32.process_bytes( head.get(), length );
+    }
+    uint32_t checksum = crc32.checksum();
+    auto result = write( fd, reinterpret_cast< void* >( &checksum ), sizeof( checksum ) );
+    if( result != sizeof( checksum ) ) throw unable_to_load_file();
+  }
+  void network::clip( vk::CommandBuffer &command_buffer ) const {
+    for( const auto &layer: clipping )
+      (*layer)( command_buffer );
+  }
   void network::fill( bool fill_to_eval, bool use_eval ) {
     auto &command_buffer = command_buffers->at( 3 );
     command_buffer.reset( vk::CommandBufferResetFlagBits::eReleaseResources );
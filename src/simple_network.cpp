@@ -53,8 +53,9 @@ namespace liblnn {
     const liblnn::modules &mods,
     size_t hidden_width_,
     size_t batch_size_,
+    bool megakernel_,
     bool debug_
-  ) : network( command_pool_, device_, queue_, descriptor_pool_, pipeline_cache_, props_, allocator_, tin_, ein_, mods, batch_size_, debug_ ), image_width( tin_->get_image_width() ), image_height( tin_->get_image_height() ), image_channels( tin_->get_image_channel() ), hidden_width( hidden_width_ ), output_width( tin_->get_label_width() ) {
+  ) : network( command_pool_, device_, queue_, descriptor_pool_, pipeline_cache_, props_, allocator_, tin_, ein_, mods, batch_size_, debug_ ), image_width( tin_->get_image_width() ), image_height( tin_->get_image_height() ), image_channels( tin_->get_image_channel() ), hidden_width( hidden_width_ ), output_width( tin_->get_label_width() ), megakernel( megakernel_ ) {
     auto buf_type = debug ? VMA_MEMORY_USAGE_GPU_TO_CPU : VMA_MEMORY_USAGE_GPU_ONLY;
     const unsigned int image_size = train_input->get_image_width() * train_input->get_image_height() * train_input->get_image_channel();
     hidden_weight.reset( new liblnn::buffer< glm::vec4 >(
@@ -63,14 +64,14 @@ namespace liblnn {
         .setSize( image_size * hidden_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( hidden_weight, image_size );
+    weights.emplace_back( hidden_weight, image_size, init_type::he );
     output_weight.reset( new liblnn::buffer< glm::vec4 >(
       allocator, buf_type,
       vk::BufferCreateInfo()
         .setSize( hidden_width * output_width * sizeof( glm::vec4 ) )
         .setUsage( vk::BufferUsageFlagBits::eStorageBuffer|vk::BufferUsageFlagBits::eTransferSrc|vk::BufferUsageFlagBits::eTransferDst )
     ) );
-    weights.emplace_back( output_weight, hidden_width );
+    weights.emplace_back( output_weight, hidden_width, init_type::he );
     hidden_affine_output.reset( new liblnn::buffer< float >(
       allocator, buf_type,
       vk::BufferCreateInfo()
@@ -189,33 +190,55 @@ namespace liblnn {
     hidden_affine_backward2.reset( new layer( create_affine_backward_pipeline(
       device, mods, descriptor_pool, pipeline_cache, props, batch_images[ 1 ], hidden_affine_output, hidden_weight, hidden_affine_grad, hidden_activation_grad, batch_size
     ) ) );
-    {
-      auto &command_buffer = (*command_buffers)[ 0 ];
-      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
-      (*hidden_affine1)( command_buffer );
-      (*hidden_activation)( command_buffer );
-      (*output_affine)( command_buffer );
-      (*output_activation)( command_buffer );
-      (*error1)( command_buffer );
-      (*output_activation_backward)( command_buffer );
-      (*output_affine_backward)( command_buffer );
-      (*hidden_activation_backward)( command_buffer );
-      (*hidden_affine_backward1)( command_buffer );
-      command_buffer.end();
+    if( megakernel ) {
+      mlp_scratch.reset( new liblnn::buffer< float >(
+        allocator, buf_type,
+        vk::BufferCreateInfo()
+          .setSize( ( hidden_width + output_width ) * 2 * batch_size * sizeof( float ) )
+          .setUsage( vk::BufferUsageFlagBits::eStorageBuffer )
+      ) );
+      mlp_step1.reset( new layer( create_mlp_step_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, batch_images[ 0 ], error_out, hidden_weight, batch_labels[ 0 ], output_weight, mlp_scratch, batch_size
+      ) ) );
+      mlp_step2.reset( new layer( create_mlp_step_pipeline(
+        device, mods, descriptor_pool, pipeline_cache, props, batch_images[ 1 ], error_out, hidden_weight, batch_labels[ 1 ], output_weight, mlp_scratch, batch_size
+      ) ) );
+      for( size_t index = 0; index != 2; ++index ) {
+        auto &command_buffer = (*command_buffers)[ index ];
+        command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+        (*( index ? mlp_step2 : mlp_step1 ))( command_buffer );
+        command_buffer.end();
+      }
     }
-    {
-      auto &command_buffer = (*command_buffers)[ 1 ];
-      command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
-      (*hidden_affine2)( command_buffer );
-      (*hidden_activation)( command_buffer );
-      (*output_affine)( command_buffer );
-      (*output_activation)( command_buffer );
-      (*error2)( command_buffer );
-      (*output_activation_backward)( command_buffer );
-      (*output_affine_backward)( command_buffer );
-      (*hidden_activation_backward)( command_buffer );
-      (*hidden_affine_backward2)( command_buffer );
-      command_buffer.end();
+    else {
+      {
+        auto &command_buffer = (*command_buffers)[ 0 ];
+        command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+        (*hidden_affine1)( command_buffer );
+        (*hidden_activation)( command_buffer );
+        (*output_affine)( command_buffer );
+        (*output_activation)( command_buffer );
+        (*error1)( command_buffer );
+        (*output_activation_backward)( command_buffer );
+        (*output_affine_backward)( command_buffer );
+        (*hidden_activation_backward)( command_buffer );
+        (*hidden_affine_backward1)( command_buffer );
+        command_buffer.end();
+      }
+      {
+        auto &command_buffer = (*command_buffers)[ 1 ];
+        command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eSimultaneousUse ) );
+        (*hidden_affine2)( command_buffer );
+        (*hidden_activation)( command_buffer );
+        (*output_affine)( command_buffer );
+        (*output_activation)( command_buffer );
+        (*error2)( command_buffer );
+        (*output_activation_backward)( command_buffer );
+        (*output_affine_backward)( command_buffer );
+        (*hidden_activation_backward)( command_buffer );
+        (*hidden_affine_backward2)( command_buffer );
+        command_buffer.end();
+      }
     }
     {
       auto &command_buffer = (*command_buffers)[ 2 ];
@@ -95,7 +95,7 @@ int main( int argc, const char *argv[] ) {
   if( std::filesystem::exists( std::filesystem::path( config.dump_file ) ) )
     network.restore( config.dump_file );
   else
-    network.init();
+    network.init( config.seed );
   for( size_t i = 0; i != 60000 * 100 / batch_size; ++i ) {
     network.exec();
     if( ( i * batch_size ) % 60000 == 0 ) {
@@ -48,6 +48,7 @@ SOFTWARE.
 #include <liblnn/data_source.h>
 #include <liblnn/input_cache.h>
 #include <liblnn/network.h>
+#include <liblnn/tuning.h>
 
 int main( int argc, const char *argv[] ) {
   auto config = liblnn::parse_configs( argc, argv );
@@ -56,20 +57,21 @@ int main( int argc, const char *argv[] ) {
     {},{},
     {},{}
   );
-  const auto props = liblnn::get_device_props( physical_device );
+  auto props = liblnn::get_device_props( physical_device );
+  if( !config.tuning_file.empty() && std::filesystem::exists( std::filesystem::path( config.tuning_file ) ) )
+    props.set_tuning( liblnn::load_tuning_db( config.tuning_file ) );
   auto [device,queue,command_pool] = liblnn::get_device(
     config, physical_device, {}, {}
   );
   std::vector< vk::DescriptorPoolSize > descriptor_pool_size{
     vk::DescriptorPoolSize().setType( vk::DescriptorType::eStorageBuffer ).setDescriptorCount( 2 )
   };
-  auto descriptor_pool = liblnn::get_descriptior_pool( device, descriptor_pool_size, 100 );
+  auto descriptor_pool = liblnn::get_descriptior_pool( device, descriptor_pool_size, 200 + 12 * config.residual_blocks );
   auto pipeline_cache = liblnn::get_pipeline_cache( device );
 
   liblnn::modules mods( device );
 
   auto allocator = liblnn::get_allocator( physical_device, device );
-  const size_t hidden_width = config.hidden_width;
   const size_t batch_size = config.batch_size;
   std::shared_ptr< liblnn::mnist > tin_( new liblnn::mnist(
     config.train_data,
@@ -79,8 +81,9 @@ int main( int argc, const char *argv[] ) {
     config.eval_data,
     config.eval_label
   ) );
-  std::shared_ptr< liblnn::input_cache > tin( new liblnn::input_cache( allocator, tin_, batch_size * 100 ) );
-  std::shared_ptr< liblnn::input_cache > ein( new liblnn::input_cache( allocator, ein_, batch_size * 10 ) );
+  const auto layout = config.nhwc ? liblnn::tensor_layout::nhwc : liblnn::tensor_layout::nchw;
+  std::shared_ptr< liblnn::input_cache > tin( new liblnn::input_cache( allocator, tin_, batch_size * 100, layout ) );
+  std::shared_ptr< liblnn::input_cache > ein( new liblnn::input_cache( allocator, ein_, batch_size * 10, layout ) );
   liblnn::conv10 network(
     command_pool,
     device,
@@ -92,18 +95,14 @@ int main( int argc, const char *argv[] ) {
     tin,
     ein,
     mods,
-    config.c1_channels,
-    config.c2_channels,
-    hidden_width,
-    batch_size,
-    config.debug_mode
+    config
   );
   if( std::filesystem::exists( std::filesystem::path( config.dump_file ) ) ) {
     std::cout << "restart from " << config.dump_file << std::endl;
     network.restore( config.dump_file );
   }
   else
-    network.init();
+    network.init( config.seed );
   for( size_t i = 0; i != 60000 * 1000; i += batch_size ) {
     network.exec();
     if( ( i + batch_size ) % 60000 < batch_size ) {
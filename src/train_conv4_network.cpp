@@ -102,7 +102,7 @@ int main( int argc, const char *argv[] ) {
     network.restore( config.dump_file );
   }
   else
-    network.init();
+    network.init( config.seed );
   for( size_t i = 0; i != 60000 * 1000; i += batch_size ) {
     network.exec();
     if( ( i + batch_size ) % 60000 < batch_size ) {
@@ -93,6 +93,7 @@ int main( int argc, const char *argv[] ) {
     mods,
     hidden_width,
     batch_size,
+    config.megakernel,
     config.debug_mode
   );
   if( std::filesystem::exists( std::filesystem::path( config.dump_file ) ) ) {
@@ -100,7 +101,7 @@ int main( int argc, const char *argv[] ) {
     network.restore( config.dump_file );
   }
   else
-    network.init();
+    network.init( config.seed );
   for( size_t i = 0; i != 60000 * 1000; i += batch_size ) {
     network.exec();
     if( ( i + batch_size ) % 60000 < batch_size ) {
@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <filesystem>
+#include <boost/math/common_factor_rt.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vk_mem_alloc.h>
+#include <glm/vec4.hpp>
+#include <liblnn/config.h>
+#include <liblnn/instance.h>
+#include <liblnn/device.h>
+#include <liblnn/shader.h>
+#include <liblnn/command_buffer.h>
+#include <liblnn/modules.h>
+#include <liblnn/device_props.h>
+#include <liblnn/layer_def.h>
+#include <liblnn/layer.h>
+#include <liblnn/pipeline_cache.h>
+#include <liblnn/descriptor_pool.h>
+#include <liblnn/descriptor_set.h>
+#include <liblnn/pipeline_layout.h>
+#include <liblnn/allocator.h>
+#include <liblnn/buffer.h>
+#include <liblnn/pipeline.h>
+#include <liblnn/load_mnist.h>
+#include <liblnn/data_source.h>
+#include <liblnn/input_cache.h>
+#include <liblnn/network.h>
+#include <liblnn/tuning.h>
+
+int main( int argc, const char *argv[] ) {
+  auto config = liblnn::parse_configs( argc, argv );
+  auto [instance,physical_device] = liblnn::get_instance(
+    config,
+    {},{},
+    {},{}
+  );
+  auto props = liblnn::get_device_props( physical_device );
+  std::shared_ptr< liblnn::tuning_db > tuning( new liblnn::tuning_db() );
+  props.set_tuning( tuning );
+  auto [device,queue,command_pool] = liblnn::get_device(
+    config, physical_device, {}, {}
+  );
+  std::vector< vk::DescriptorPoolSize > descriptor_pool_size{
+    vk::DescriptorPoolSize().setType( vk::DescriptorType::eStorageBuffer ).setDescriptorCount( 2 )
+  };
+  auto descriptor_pool = liblnn::get_descriptior_pool( device, descriptor_pool_size, 200 + 12 * config.residual_blocks );
+  auto pipeline_cache = liblnn::get_pipeline_cache( device );
+
+  liblnn::modules mods( device );
+
+  auto allocator = liblnn::get_allocator( physical_device, device );
+  const size_t batch_size = config.batch_size;
+  std::shared_ptr< liblnn::mnist > tin_( new liblnn::mnist(
+    config.train_data,
+    config.train_label
+  ) );
+  std::shared_ptr< liblnn::mnist > ein_( new liblnn::mnist(
+    config.eval_data,
+    config.eval_label
+  ) );
+  const auto layout = config.nhwc ? liblnn::tensor_layout::nhwc : liblnn::tensor_layout::nchw;
+  std::shared_ptr< liblnn::input_cache > tin( new liblnn::input_cache( allocator, tin_, batch_size * 100, layout ) );
+  std::shared_ptr< liblnn::input_cache > ein( new liblnn::input_cache( allocator, ein_, batch_size * 10, layout ) );
+  if( config.tuning_file.empty() ) {
+    std::cerr << "--tuning_file is required" << std::endl;
+    return 1;
+  }
+  if( std::filesystem::exists( std::filesystem::path( config.tuning_file ) ) )
+    tuning->load( config.tuning_file );
+  tuning->start_profiling( device, queue, command_pool, props, 8192u );
+  // building the network registers every kernel's candidates, so the count is known after the first pass
+  for( uint32_t candidate = 0u; candidate < tuning->get_candidate_count(); ++candidate ) {
+    tuning->set_candidate( candidate );
+    liblnn::conv10 network(
+      command_pool,
+      device,
+      queue,
+      descriptor_pool,
+      pipeline_cache,
+      props,
+      allocator,
+      tin,
+      ein,
+      mods,
+      config
+    );
+    network.init( config.seed );
+    for( size_t i = 0; i != 10; ++i )
+      network.exec();
+    for( size_t i = 0; i != 10; ++i ) {
+      network.exec();
+      tuning->collect();
+    }
+    std::cout << "candidate " << candidate << " done." << std::endl;
+  }
+  tuning->stop_profiling();
+  tuning->save( config.tuning_file );
+  std::cout << "ok" << std::endl;
+}
+
@@ -0,0 +1,184 @@
+/*
+Copyright (c) 2019 Naomasa Matsubayashi (aka. Fadis)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <liblnn/tuning.h>
+#include <liblnn/device_props.h>
+#include <liblnn/command_buffer.h>
+#include <liblnn/exceptions.h>
+namespace liblnn {
+  void tuning_db::load( const std::string &filename ) {
+    std::ifstream stream( filename );
+    if( !stream.good() ) throw unable_to_load_file();
+    std::string line;
+    while( std::getline( stream, line ) ) {
+      if( line.empty() ) continue;
+      // key local_size tile ns, or key local_size ns in files written before tiles were tuned
+      std::istringstream fields( line );
+      std::string key;
+      std::vector< double > values;
+      double value;
+      fields >> key;
+      while( fields >> value ) values.push_back( value );
+      if( !fields.eof() || ( values.size() != 2u && values.size() != 3u ) ) throw corrupted_file();
+      const tuning_parameters parameters( uint32_t( values[ 0 ] ), values.size() == 3u ? uint32_t( values[ 1 ] ) : 1u );
+      best[ key ] = std::make_pair( parameters, values.back() );
+    }
+  }
+  void tuning_db::save( const std::string &filename ) const {
+    std::ofstream stream( filename, std::ios::out | std::ios::trunc );
+    if( !stream.good() ) throw unable_to_load_file();
+    for( const auto &[key,value]: best )
+      stream << key << ' ' << value.first.first << ' ' << value.first.second << ' ' << value.second << std::endl;
+  }
+  tuning_parameters tuning_db::get_parameters( const std::string &key, const std::vector< tuning_parameters > &candidates, const tuning_parameters &default_parameters ) {
+    candidate_count = std::max( candidate_count, uint32_t( candidates.size() ) );
+    if( is_profiling() )
+      return candidates[ std::min( candidate, uint32_t( candidates.size() - 1u ) ) ];
+    const auto existing = best.find( key );
+    if( existing == best.end() ) return default_parameters;
+    if( std::find( candidates.begin(), candidates.end(), existing->second.first ) == candidates.end() ) return default_parameters;
+    return existing->second.first;
+  }
+  void tuning_db::start_profiling(
+    const std::shared_ptr< vk::Device > &device_,
+    const std::shared_ptr< vk::Queue > &queue_,
+    const std::shared_ptr< vk::CommandPool > &command_pool_,
+    const device_props &props,
+    uint32_t query_count_
+  ) {
+    if( !props.props.limits.timestampComputeAndGraphics ) throw timestamp_is_not_available();
+    device = device_;
+    queue = queue_;
+    command_pool = command_pool_;
+    query_count = query_count_;
+    timestamp_period = props.props.limits.timestampPeriod;
+    query_pool.reset(
+      new vk::QueryPool( device->createQueryPool(
+        vk::QueryPoolCreateInfo()
+          .setQueryType( vk::QueryType::eTimestamp )
+          .setQueryCount( query_count )
+      ) ),
+      [device=device_]( vk::QueryPool *p ) {
+        if( p ) device->destroyQueryPool( *p );
+        delete p;
+      }
+    );
+    set_candidate( 0u );
+  }
+  void tuning_db::set_candidate( uint32_t index ) {
+    candidate = index;
+    next_query = 0u;
+    queries.clear();
+    if( !query_pool ) return;
+    auto command_buffers = liblnn::get_command_buffers( device, command_pool, 1 );
+    auto &command_buffer = (*command_buffers)[ 0 ];
+    command_buffer.begin( vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+    command_buffer.resetQueryPool( *query_pool, 0, query_count );
+    command_buffer.end();
+    queue->submit(
+      vk::SubmitInfo()
+        .setCommandBufferCount( 1 )
+        .setPCommandBuffers( &command_buffer ),
+      vk::Fence()
+    );
+    queue->waitIdle();
+  }
+  uint32_t tuning_db::begin( vk::CommandBuffer &command_buffer, const std::string &key, const tuning_parameters &parameters ) {
+    if( !query_pool || next_query + 2u > query_count ) return query_count;
+    const uint32_t query = next_query;
+    next_query += 2u;
+    queries.emplace_back( key, parameters );
+    command_buffer.resetQueryPool( *query_pool, query, 2 );
+    command_buffer.writeTimestamp( vk::PipelineStageFlagBits::eComputeShader, *query_pool, query );
+    return query;
+  }
+  void tuning_db::end( vk::CommandBuffer &command_buffer, uint32_t query ) {
+    if( !query_pool || query >= query_count ) return;
+    command_buffer.writeTimestamp( vk::PipelineStageFlagBits::eComputeShader, *query_pool, query + 1u );
+  }
+  void tuning_db::collect() {
+    if( !query_pool || !next_query ) return;
+    std::vector< uint64_t > results( next_query * 2u, 0u );
+    const auto result = device->getQueryPoolResults(
+      *query_pool, 0, next_query,
+      results.size() * sizeof( uint64_t ), results.data(), sizeof( uint64_t ) * 2u,
+      vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability
+    );
+    if( result != vk::Result::eSuccess && result != vk::Result::eNotReady ) return;
+    for( uint32_t index = 0u; index != queries.size(); ++index ) {
+      const uint64_t *timestamps = results.data() + index * 4u;
+      if( !timestamps[ 1 ] || !timestamps[ 3 ] || timestamps[ 2 ] < timestamps[ 0 ] ) continue;
+      const double ns = double( timestamps[ 2 ] - timestamps[ 0 ] ) * timestamp_period;
+      const auto &[key,parameters] = queries[ index ];
+      const auto existing = best.find( key );
+      if( existing == best.end() || existing->second.second > ns )
+        best[ key ] = std::make_pair( parameters, ns );
+    }
+  }
+  void tuning_db::stop_profiling() {
+    queries.clear();
+    next_query = 0u;
+    query_pool.reset();
+  }
+  std::shared_ptr< tuning_db > load_tuning_db( const std::string &filename ) {
+    std::shared_ptr< tuning_db > db( new tuning_db() );
+    db->load( filename );
+    return db;
+  }
+  tuning_entry get_tuning_entry(
+    const device_props &props,
+    const std::string &kernel,
+    const std::vector< uint32_t > &shape,
+    uint32_t default_size,
+    uint32_t max_size,
+    const std::vector< uint32_t > &tiles
+  ) {
+    const uint32_t default_tile = tiles.empty() ? 1u : tiles.front();
+    if( !props.tuning ) return tuning_entry().set_local_size( default_size ).set_tile( default_tile );
+    const uint32_t subgroup_size = props.subgroup_props.subgroupSize;
+    const uint32_t limit = std::min( props.props.limits.maxComputeWorkGroupSize[ 0 ], props.props.limits.maxComputeWorkGroupInvocations );
+    const uint32_t aligned_max = ( max_size / subgroup_size + ( ( max_size % subgroup_size ) ? 1 : 0 ) ) * subgroup_size;
+    std::vector< uint32_t > sizes;
+    for( uint32_t scale = 1u; scale <= 16u; scale *= 2u ) {
+      const uint32_t size = subgroup_size * scale;
+      if( size > limit || ( scale != 1u && size > aligned_max ) ) break;
+      sizes.push_back( size );
+    }
+    std::vector< tuning_parameters > candidates;
+    for( const auto &tile: tiles.empty() ? std::vector< uint32_t >{ 1u } : tiles )
+      for( const auto &size: sizes )
+        candidates.emplace_back( size, tile );
+    std::string key = std::to_string( props.props.vendorID ) + ':' + std::to_string( props.props.deviceID ) + ':' + std::to_string( props.props.driverVersion ) + ':' + kernel;
+    for( const auto &value: shape )
+      key += ':' + std::to_string( value );
+    const auto [local_size,tile] = props.tuning->get_parameters( key, candidates, tuning_parameters( default_size, default_tile ) );
+    return tuning_entry()
+      .set_db( props.tuning )
+      .set_key( key )
+      .set_local_size( local_size )
+      .set_tile( tile );
+  }
+}
+